@@ -20,8 +20,8 @@ toolchain = generator.toolchain
 
 render_lib = generator.lib(module='render', sources=[
     'backend.c', 'buffer.c', 'command.c', 'context.c', 'compile.c', 'drawable.c', 'event.c', 'indexbuffer.c', 'import.c',
-    'parameter.c', 'pipeline.c', 'program.c', 'projection.c', 'render.c', 'shader.c', 'state.c', 'sort.c', 'target.c',
-    'texture.c', 'version.c', 'vertexbuffer.c',
+    'mesh.c', 'palette.c', 'parameter.c', 'pipeline.c', 'pool.c', 'program.c', 'projection.c', 'render.c', 'scaling.c', 'shader.c', 'state.c', 'sort.c', 'target.c',
+    'texture.c', 'trace.c', 'transform.c', 'version.c', 'vertexbuffer.c', 'vertexformat.c',
     os.path.join('gl4', 'backend.c'), os.path.join(
         'gl4', 'backend.m'), os.path.join('gl4', 'glprocs.c'),
     os.path.join('gl2', 'backend.c'),
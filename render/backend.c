@@ -208,6 +208,8 @@ render_backend_allocate(render_api_t api, bool allow_fallback) {
 
 	render_target_initialize_framebuffer(&backend->framebuffer, backend);
 	backend->framecount = 1;
+	atomic_storeptr(&backend->destroyqueue, nullptr, memory_order_release);
+	backend->destroypending = nullptr;
 
 	uuidmap_initialize((uuidmap_t*)&backend->shadertable,
 	                   sizeof(backend->shadertable.bucket) / sizeof(backend->shadertable.bucket[0]),
@@ -235,6 +237,8 @@ render_backend_deallocate(render_backend_t* backend) {
 	if (!backend)
 		return;
 
+	render_backend_destroy_queued(backend, true);
+
 	backend->vtable.destruct(backend);
 
 	uuidmap_finalize((uuidmap_t*)&backend->shadertable);
@@ -245,6 +249,8 @@ render_backend_deallocate(render_backend_t* backend) {
 	render_drawable_finalize(&backend->drawable);
 
 	mutex_deallocate(backend->exclusive);
+	array_deallocate(backend->uploadqueue);
+	array_deallocate(backend->dispatch_slot_hash);
 
 	for (size_t ib = 0, bsize = array_size(_render_backends); ib < bsize; ++ib) {
 		if (_render_backends[ib] == backend) {
@@ -333,18 +339,618 @@ render_backend_target_framebuffer(render_backend_t* backend) {
 	return &backend->framebuffer;
 }
 
+const render_backend_statistics_t*
+render_backend_statistics(render_backend_t* backend) {
+	return &backend->statistics;
+}
+
+static void
+render_backend_memory_peak(atomic64_t* peak, int64_t value) {
+	int64_t current = atomic_load64(peak, memory_order_relaxed);
+	while ((value > current) && !atomic_cas64(peak, value, current, memory_order_relaxed,
+	                                           memory_order_relaxed))
+		current = atomic_load64(peak, memory_order_relaxed);
+}
+
+static void
+render_backend_memory_check_budget(render_backend_t* backend, uint64_t system, uint64_t gpu) {
+	render_backend_memory_t* memory = &backend->memory;
+	bool over = (memory->system_budget && (system > memory->system_budget)) ||
+	            (memory->gpu_budget && (gpu > memory->gpu_budget));
+	if (!over) {
+		if (atomic_load32(&memory->over_budget, memory_order_relaxed))
+			atomic_store32(&memory->over_budget, 0, memory_order_relaxed);
+		return;
+	}
+	// Only notify when crossing into over budget, not on every allocation while over
+	if (atomic_cas32(&memory->over_budget, 1, 0, memory_order_acq_rel, memory_order_relaxed) &&
+	    memory->budget_callback) {
+		render_memory_usage_t usage = render_backend_memory_total(backend);
+		memory->budget_callback(backend, &usage, memory->budget_userdata);
+	}
+}
+
+void
+render_backend_memory_track(render_backend_t* backend, render_resource_type_t type,
+                            unsigned int usage, int64_t system, int64_t gpu) {
+	if (!backend || (!system && !gpu))
+		return;
+	render_backend_memory_t* memory = &backend->memory;
+	if (usage >= RENDERUSAGE_NUM)
+		usage = RENDERUSAGE_INVALID;
+	int64_t system_total = atomic_load64(&memory->system_total, memory_order_relaxed);
+	int64_t gpu_total = atomic_load64(&memory->gpu_total, memory_order_relaxed);
+	if (system) {
+		int64_t value = atomic_add64(&memory->system[type][usage], system, memory_order_relaxed);
+		system_total = atomic_add64(&memory->system_total, system, memory_order_relaxed);
+		render_backend_memory_peak(&memory->system_peak[type][usage], value);
+		render_backend_memory_peak(&memory->system_total_peak, system_total);
+	}
+	if (gpu) {
+		int64_t value = atomic_add64(&memory->gpu[type][usage], gpu, memory_order_relaxed);
+		gpu_total = atomic_add64(&memory->gpu_total, gpu, memory_order_relaxed);
+		render_backend_memory_peak(&memory->gpu_peak[type][usage], value);
+		render_backend_memory_peak(&memory->gpu_total_peak, gpu_total);
+	}
+	if (memory->system_budget || memory->gpu_budget)
+		render_backend_memory_check_budget(backend, (uint64_t)system_total, (uint64_t)gpu_total);
+}
+
+void
+render_backend_memory_track_buffer(render_buffer_t* buffer, int64_t system, int64_t gpu) {
+	render_resource_type_t type;
+	switch (buffer->buffertype) {
+		case RENDERBUFFER_VERTEX:
+			type = RENDERRESOURCE_VERTEXBUFFER;
+			break;
+		case RENDERBUFFER_INDEX:
+			type = RENDERRESOURCE_INDEXBUFFER;
+			break;
+		case RENDERBUFFER_PARAMETER:
+			type = RENDERRESOURCE_PARAMETERBUFFER;
+			break;
+		case RENDERBUFFER_STATE:
+			type = RENDERRESOURCE_STATEBUFFER;
+			break;
+		case RENDERBUFFER_PALETTE:
+			type = RENDERRESOURCE_PALETTEBUFFER;
+			break;
+		default:
+			return;
+	}
+	render_backend_memory_track(buffer->backend, type, buffer->usage, system, gpu);
+}
+
+render_memory_usage_t
+render_backend_memory_usage(render_backend_t* backend, render_resource_type_t type,
+                            render_usage_t usage) {
+	render_memory_usage_t result = {0, 0, 0, 0};
+	if ((type >= RENDERRESOURCE_NUM) || (usage >= RENDERUSAGE_NUM))
+		return result;
+	render_backend_memory_t* memory = &backend->memory;
+	result.system = (uint64_t)atomic_load64(&memory->system[type][usage], memory_order_relaxed);
+	result.gpu = (uint64_t)atomic_load64(&memory->gpu[type][usage], memory_order_relaxed);
+	result.system_peak =
+	    (uint64_t)atomic_load64(&memory->system_peak[type][usage], memory_order_relaxed);
+	result.gpu_peak = (uint64_t)atomic_load64(&memory->gpu_peak[type][usage], memory_order_relaxed);
+	return result;
+}
+
+render_memory_usage_t
+render_backend_memory_type_usage(render_backend_t* backend, render_resource_type_t type) {
+	render_memory_usage_t result = {0, 0, 0, 0};
+	for (unsigned int usage = 0; usage < RENDERUSAGE_NUM; ++usage) {
+		render_memory_usage_t current =
+		    render_backend_memory_usage(backend, type, (render_usage_t)usage);
+		result.system += current.system;
+		result.gpu += current.gpu;
+		// Peaks of the usage classes were not necessarily reached at the same time,
+		// the sum is an upper bound of the peak of the resource type
+		result.system_peak += current.system_peak;
+		result.gpu_peak += current.gpu_peak;
+	}
+	return result;
+}
+
+render_memory_usage_t
+render_backend_memory_total(render_backend_t* backend) {
+	render_backend_memory_t* memory = &backend->memory;
+	render_memory_usage_t result;
+	result.system = (uint64_t)atomic_load64(&memory->system_total, memory_order_relaxed);
+	result.gpu = (uint64_t)atomic_load64(&memory->gpu_total, memory_order_relaxed);
+	result.system_peak = (uint64_t)atomic_load64(&memory->system_total_peak, memory_order_relaxed);
+	result.gpu_peak = (uint64_t)atomic_load64(&memory->gpu_total_peak, memory_order_relaxed);
+	return result;
+}
+
+void
+render_backend_memory_reset_peak(render_backend_t* backend) {
+	render_backend_memory_t* memory = &backend->memory;
+	for (unsigned int type = 0; type < RENDERRESOURCE_NUM; ++type) {
+		for (unsigned int usage = 0; usage < RENDERUSAGE_NUM; ++usage) {
+			atomic_store64(&memory->system_peak[type][usage],
+			               atomic_load64(&memory->system[type][usage], memory_order_relaxed),
+			               memory_order_relaxed);
+			atomic_store64(&memory->gpu_peak[type][usage],
+			               atomic_load64(&memory->gpu[type][usage], memory_order_relaxed),
+			               memory_order_relaxed);
+		}
+	}
+	atomic_store64(&memory->system_total_peak,
+	               atomic_load64(&memory->system_total, memory_order_relaxed), memory_order_relaxed);
+	atomic_store64(&memory->gpu_total_peak,
+	               atomic_load64(&memory->gpu_total, memory_order_relaxed), memory_order_relaxed);
+}
+
 void
+render_backend_set_memory_budget(render_backend_t* backend, uint64_t system_budget,
+                                 uint64_t gpu_budget, render_memory_budget_fn callback,
+                                 void* userdata) {
+	render_backend_memory_t* memory = &backend->memory;
+	memory->system_budget = system_budget;
+	memory->gpu_budget = gpu_budget;
+	memory->budget_callback = callback;
+	memory->budget_userdata = userdata;
+	atomic_store32(&memory->over_budget, 0, memory_order_release);
+	if (system_budget || gpu_budget) {
+		render_memory_usage_t usage = render_backend_memory_total(backend);
+		render_backend_memory_check_budget(backend, usage.system, usage.gpu);
+	}
+}
+
+static void
+render_backend_queue_upload(render_backend_t* backend, render_buffer_t* buffer) {
+	// Buffers referenced by multiple commands are only queued once per pass. The pass is
+	// tracked outside the flags, which are concurrently written under the buffer lock
+	if (buffer && (buffer->uploadpass != backend->uploadpass) &&
+	    (buffer->flags & RENDERBUFFER_DIRTY) && (buffer->policy != RENDERBUFFER_UPLOAD_ONRENDER)) {
+		buffer->uploadpass = backend->uploadpass;
+		array_push(backend->uploadqueue, buffer);
+	}
+}
+
+static bool
+render_backend_resolve_command(render_command_t* command) {
+	// A stale handle means the resource was destroyed and the slot possibly reused
+	const render_command_render_t* render = &command->data.render;
+	bool valid =
+	    !((render->program_handle &&
+	       (render_program_resolve(render->program_handle) != render->program)) ||
+	      (render->vertexbuffer_handle &&
+	       ((void*)render_buffer_resolve(render->vertexbuffer_handle) != render->vertexbuffer)) ||
+	      (render->indexbuffer_handle &&
+	       ((void*)render_buffer_resolve(render->indexbuffer_handle) != render->indexbuffer)) ||
+	      (render->parameterbuffer_handle &&
+	       ((void*)render_buffer_resolve(render->parameterbuffer_handle) !=
+	        render->parameterbuffer)) ||
+	      (render->statebuffer_handle &&
+	       ((void*)render_buffer_resolve(render->statebuffer_handle) != render->statebuffer)) ||
+	      (render->palettebuffer_handle &&
+	       ((void*)render_buffer_resolve(render->palettebuffer_handle) != render->palettebuffer)));
+	for (size_t istream = 0; valid && (istream < RENDER_MAX_VERTEX_BINDINGS - 1); ++istream)
+		valid = !render->vertexstream_handle[istream] ||
+		        ((void*)render_buffer_resolve(render->vertexstream_handle[istream]) ==
+		         render->vertexstream[istream]);
+	if (!valid) {
+		log_warn(HASH_RENDER, WARNING_INVALID_VALUE,
+		         STRING_CONST("Render command references destroyed resource, skipped"));
+		command->type = RENDERCOMMAND_INVALID;
+	}
+	return valid;
+}
+
+static size_t
+render_backend_upload_queued(render_backend_t* backend, render_context_t** contexts,
+                             size_t num_contexts) {
+	// Zero is reserved for buffers never queued
+	if (!++backend->uploadpass)
+		++backend->uploadpass;
+	for (size_t i = 0; i < num_contexts; ++i) {
+		render_context_t* context = contexts[i];
+		int32_t cmd_size = atomic_load32(&context->reserved, memory_order_acquire);
+		render_command_t* command = context->commands;
+		for (int32_t icmd = 0; icmd < cmd_size; ++icmd, ++command) {
+			if (command->type < RENDERCOMMAND_RENDER_TRIANGLELIST)
+				continue;
+			if (!render_backend_resolve_command(command))
+				continue;
+			render_backend_queue_upload(backend, (render_buffer_t*)command->data.render.vertexbuffer);
+			render_backend_queue_upload(backend, (render_buffer_t*)command->data.render.indexbuffer);
+			for (size_t istream = 0; istream < RENDER_MAX_VERTEX_BINDINGS - 1; ++istream)
+				render_backend_queue_upload(
+				    backend, (render_buffer_t*)command->data.render.vertexstream[istream]);
+			render_backend_queue_upload(backend, (render_buffer_t*)command->data.render.palettebuffer);
+		}
+	}
+
+	size_t queued = array_size(backend->uploadqueue);
+	if (queued) {
+		render_buffer_upload_batch(backend, backend->uploadqueue, queued);
+		array_clear(backend->uploadqueue);
+	}
+	return queued;
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+render_backend_hash_combine(uint64_t hash, uint64_t value) {
+	hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	return hash;
+}
+
+static uint64_t
+render_backend_hash_real(uint64_t hash, float64_t value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return render_backend_hash_combine(hash, bits);
+}
+
+static uint64_t
+render_backend_hash_state(const render_state_t* state) {
+	return hash(state, sizeof(render_state_t));
+}
+
+static uint64_t
+render_backend_hash_buffer(uint64_t hash, const render_buffer_t* buffer) {
+	hash = render_backend_hash_combine(hash, (uint64_t)(uintptr_t)buffer);
+	// Buffers left dirty are uploaded when drawn, so their content changed
+	if (buffer && (buffer->flags & RENDERBUFFER_DIRTY))
+		hash = render_backend_hash_combine(hash, (uint64_t)render_buffer_generation());
+	return hash;
+}
+
+static uint64_t
+render_backend_hash_parameters(uint64_t hash, render_backend_t* backend,
+                               const render_parameterbuffer_t* parameterbuffer) {
+	hash = render_backend_hash_combine(hash, (uint64_t)(uintptr_t)parameterbuffer);
+	if (!parameterbuffer)
+		return hash;
+	hash = render_backend_hash_combine(hash, parameterbuffer->generation);
+	if (!parameterbuffer->store)
+		return hash;
+	// Bound texture objects are part of the parameter data, but texture content is not,
+	// so any texture upload since the last frame changes the hash
+	bool textures = false;
+	const render_parameter_t* param = parameterbuffer->parameters;
+	for (unsigned int ip = 0; ip < parameterbuffer->parameter_count; ++ip, ++param) {
+		if (param->type != RENDERPARAMETER_TEXTURE)
+			continue;
+		const uint32_t* names = pointer_offset_const(parameterbuffer->store, param->offset);
+		for (uint16_t idim = 0; idim < param->dim; ++idim)
+			hash = render_backend_hash_combine(hash, names[idim]);
+		textures = true;
+	}
+	if (textures)
+		hash = render_backend_hash_combine(
+		    hash, (uint32_t)atomic_load32(&backend->texture_generation, memory_order_acquire));
+	return hash;
+}
+
+static uint64_t
+render_backend_hash_command(uint64_t hash, render_backend_t* backend,
+                            const render_command_t* command) {
+	hash = render_backend_hash_combine(hash, ((uint64_t)command->type << 32ULL) | command->count);
+	switch (command->type) {
+		case RENDERCOMMAND_CLEAR: {
+			const render_command_clear_t* clear = &command->data.clear;
+			hash = render_backend_hash_combine(
+			    hash, ((uint64_t)clear->buffer_mask << 32ULL) | clear->color_mask);
+			hash = render_backend_hash_combine(hash, ((uint64_t)clear->color << 32ULL) |
+			                                             clear->stencil);
+			hash = render_backend_hash_real(hash, (float64_t)clear->depth);
+			break;
+		}
+
+		case RENDERCOMMAND_VIEWPORT: {
+			const render_command_viewport_t* viewport = &command->data.viewport;
+			hash = render_backend_hash_combine(
+			    hash, ((uint64_t)(uint32_t)viewport->x << 32ULL) | (uint32_t)viewport->y);
+			hash = render_backend_hash_combine(hash, ((uint64_t)(uint32_t)viewport->width << 32ULL) |
+			                                             (uint32_t)viewport->height);
+			hash = render_backend_hash_real(hash, (float64_t)viewport->min_z);
+			hash = render_backend_hash_real(hash, (float64_t)viewport->max_z);
+			break;
+		}
+
+		case RENDERCOMMAND_BLIT: {
+			// Source content is identified by the last command stream dispatched to it
+			const render_command_blit_t* blit = &command->data.blit;
+			hash = render_backend_hash_combine(hash, (uint64_t)(uintptr_t)blit->source);
+			if (blit->source)
+				hash = render_backend_hash_combine(hash, blit->source->dispatch_hash);
+			hash = render_backend_hash_combine(hash, ((uint64_t)(uint32_t)blit->source_x << 32ULL) |
+			                                             (uint32_t)blit->source_y);
+			hash = render_backend_hash_combine(
+			    hash, ((uint64_t)(uint32_t)blit->source_width << 32ULL) |
+			              (uint32_t)blit->source_height);
+			hash = render_backend_hash_combine(
+			    hash, ((uint64_t)(uint32_t)blit->x << 32ULL) | (uint32_t)blit->y);
+			hash = render_backend_hash_combine(
+			    hash, ((uint64_t)(uint32_t)blit->width << 32ULL) | (uint32_t)blit->height);
+			hash = render_backend_hash_combine(hash, blit->buffer_mask);
+			break;
+		}
+
+		case RENDERCOMMAND_RENDER_TRIANGLELIST:
+		case RENDERCOMMAND_RENDER_LINELIST: {
+			const render_command_render_t* render = &command->data.render;
+			hash = render_backend_hash_combine(hash, (uint64_t)(uintptr_t)render->program);
+			hash = render_backend_hash_buffer(hash, (const render_buffer_t*)render->vertexbuffer);
+			hash = render_backend_hash_buffer(hash, (const render_buffer_t*)render->indexbuffer);
+			for (size_t istream = 0; istream < RENDER_MAX_VERTEX_BINDINGS - 1; ++istream)
+				hash = render_backend_hash_buffer(hash,
+				                                  (const render_buffer_t*)render->vertexstream[istream]);
+			hash = render_backend_hash_buffer(hash, (const render_buffer_t*)render->palettebuffer);
+			hash = render_backend_hash_combine(hash, render->palette_offset);
+			hash = render_backend_hash_parameters(hash, backend, render->parameterbuffer);
+			// State buffers are read at draw, include the state itself
+			hash = render_backend_hash_combine(hash, (uint64_t)(uintptr_t)render->statebuffer);
+			if (render->statebuffer)
+				hash = render_backend_hash_combine(
+				    hash, render_backend_hash_state(&render->statebuffer->state));
+			break;
+		}
+
+		default:
+			break;
+	}
+	return hash;
+}
+
+static uint64_t
+render_backend_dispatch_hash(render_backend_t* backend, render_target_t* target,
+                             render_context_t** contexts, size_t num_contexts) {
+	uint64_t hash = render_backend_hash_combine(
+	    (uint64_t)(uintptr_t)target, ((uint64_t)target->width << 32ULL) | target->height);
+	for (size_t i = 0; i < num_contexts; ++i) {
+		const render_context_t* context = contexts[i];
+		size_t cmd_size = (size_t)atomic_load32(&context->reserved, memory_order_acquire);
+		hash = render_backend_hash_combine(hash, cmd_size);
+		for (size_t iorder = 0; iorder < cmd_size; ++iorder) {
+			size_t index = (context->sort->indextype == RADIXSORT_INDEX16) ?
+			                   ((const uint16_t*)context->order)[iorder] :
+			                   ((const uint32_t*)context->order)[iorder];
+			hash = render_backend_hash_command(hash, backend, context->commands + index);
+		}
+	}
+	// Zero is the initial hash of a target and never matches
+	return hash ? hash : 1;
+}
+
+static bool
+render_backend_dispatch_slot_matches(render_backend_t* backend, size_t slot,
+                                     const render_target_t* target, uint64_t hash) {
+	return target->dispatch_hash && (slot < array_size(backend->dispatch_slot_hash)) &&
+	       (backend->dispatch_slot_hash[slot] == hash);
+}
+
+static void
+render_backend_dispatch_store(render_backend_t* backend, size_t slot, render_target_t* target,
+                              uint64_t hash) {
+	while (array_size(backend->dispatch_slot_hash) <= slot)
+		array_push(backend->dispatch_slot_hash, 0);
+	backend->dispatch_slot_hash[slot] = hash;
+	target->dispatch_hash = hash;
+}
+
+static bool
+render_backend_dispatch_commit(render_backend_t* backend, render_target_t* target,
+                               render_context_t** contexts, size_t num_contexts, bool skip) {
+	if (skip) {
+		++backend->frame_skipped;
+		if (target == &backend->framebuffer)
+			backend->frame_framebuffer_skipped = true;
+	} else {
+		// The back buffer is undefined after a swap, a frame where a frame buffer
+		// dispatch was skipped can only be presented if nothing else was dispatched
+		if (backend->frame_framebuffer_skipped)
+			backend->frame_incomplete = true;
+		++backend->frame_dispatched;
+		tick_t trace = render_trace_begin();
+		backend->vtable.dispatch(backend, target, contexts, num_contexts);
+		render_trace_end(trace, STRING_CONST("render_backend_dispatch"));
+	}
+
+	for (size_t i = 0; i < num_contexts; ++i)
+		atomic_store32(&contexts[i]->reserved, 0, memory_order_release);
+
+	return !skip;
+}
+
+bool
 render_backend_dispatch(render_backend_t* backend, render_target_t* target,
                         render_context_t** contexts, size_t num_contexts) {
-	backend->vtable.dispatch(backend, target, contexts, num_contexts);
+	// Upload all dirty buffers before any draw is issued, buffers with an
+	// upload on render policy are uploaded by the backend when first drawn
+	size_t uploaded = render_backend_upload_queued(backend, contexts, num_contexts);
+
+	bool skip = false;
+	if (backend->skip_idle) {
+		// Dispatches are matched by order within the frame, so several dispatches to the
+		// same target each compare to their own hash from the previous frame. A dispatch
+		// earlier in the frame may have changed a target sampled by this one
+		size_t slot = backend->frame_dispatched + backend->frame_skipped;
+		uint64_t hash = render_backend_dispatch_hash(backend, target, contexts, num_contexts);
+		skip = !uploaded && !backend->frame_dispatched &&
+		       render_backend_dispatch_slot_matches(backend, slot, target, hash);
+		// Whether later dispatches of the frame match is not known yet, so a frame buffer
+		// dispatch is only skipped if it was the last dispatch of the previous frame
+		if (skip && (target == &backend->framebuffer) && (slot + 1 < backend->frame_slots))
+			skip = false;
+		render_backend_dispatch_store(backend, slot, target, hash);
+	}
+
+	return render_backend_dispatch_commit(backend, target, contexts, num_contexts, skip);
+}
+
+bool
+render_backend_dispatch_matches(render_backend_t* backend, size_t offset,
+                                render_target_t* target, render_context_t** contexts,
+                                size_t num_contexts) {
+	size_t slot = backend->frame_dispatched + backend->frame_skipped + offset;
+	uint64_t hash = render_backend_dispatch_hash(backend, target, contexts, num_contexts);
+	return render_backend_dispatch_slot_matches(backend, slot, target, hash);
+}
+
+bool
+render_backend_dispatch_frame(render_backend_t* backend, render_target_t* target,
+                              render_context_t** contexts, size_t num_contexts, bool skip) {
+	FOUNDATION_ASSERT_MSG(!skip || backend->skip_idle, "Dispatch skipped without idle skipping");
+	if (!skip)
+		render_backend_upload_queued(backend, contexts, num_contexts);
+	if (backend->skip_idle) {
+		size_t slot = backend->frame_dispatched + backend->frame_skipped;
+		// A skipped dispatch matched the hash of its slot, which is kept
+		uint64_t hash = skip ? backend->dispatch_slot_hash[slot] :
+		                       render_backend_dispatch_hash(backend, target, contexts,
+		                                                    num_contexts);
+		render_backend_dispatch_store(backend, slot, target, hash);
+	}
+	return render_backend_dispatch_commit(backend, target, contexts, num_contexts, skip);
+}
+
+void
+render_backend_dispatch_views(render_backend_t* backend, const render_view_t* views,
+                              size_t num_views, render_parameterbuffer_t** view_parameters,
+                              size_t num_view_parameters, render_context_t** contexts,
+                              size_t num_contexts) {
+	FOUNDATION_ASSERT(num_view_parameters < 0xFFFF);
+	render_backend_upload_queued(backend, contexts, num_contexts);
+
+	// Tag commands with the view parameter buffer they reference once, so substitution
+	// is a direct lookup when the contexts are dispatched for each view
+	for (size_t i = 0; i < num_contexts; ++i) {
+		render_context_t* context = contexts[i];
+		int32_t cmd_size = atomic_load32(&context->reserved, memory_order_acquire);
+		render_command_t* command = context->commands;
+		for (int32_t icmd = 0; icmd < cmd_size; ++icmd, ++command) {
+			if (command->type < RENDERCOMMAND_RENDER_TRIANGLELIST)
+				continue;
+			command->view = 0;
+			for (size_t iparam = 0; iparam < num_view_parameters; ++iparam) {
+				if (command->data.render.parameterbuffer == view_parameters[iparam]) {
+					command->view = (unsigned int)(iparam + 1);
+					break;
+				}
+			}
+		}
+	}
+
+	if (backend->frame_framebuffer_skipped)
+		backend->frame_incomplete = true;
+	++backend->frame_dispatched;
+	for (size_t iview = 0; iview < num_views; ++iview) {
+		tick_t trace = render_trace_begin();
+		backend->view = views + iview;
+		backend->vtable.dispatch(backend, views[iview].target, contexts, num_contexts);
+		render_trace_end(trace, STRING_CONST("render_backend_dispatch_view"));
+	}
+	backend->view = nullptr;
 
 	for (size_t i = 0; i < num_contexts; ++i)
 		atomic_store32(&contexts[i]->reserved, 0, memory_order_release);
 }
 
-void
+bool
 render_backend_flip(render_backend_t* backend) {
-	backend->vtable.flip(backend);
+	bool incomplete = backend->frame_incomplete;
+	bool idle = incomplete || (backend->frame_skipped && !backend->frame_dispatched);
+	if (incomplete) {
+		// Keep the previous frame presented and dispatch the next frame in full
+		array_clear(backend->dispatch_slot_hash);
+		backend->framebuffer.dispatch_hash = 0;
+	}
+	backend->frame_slots = backend->frame_dispatched + backend->frame_skipped;
+	backend->frame_skipped = 0;
+	backend->frame_dispatched = 0;
+	backend->frame_framebuffer_skipped = false;
+	backend->frame_incomplete = false;
+	if (!idle) {
+		tick_t trace = render_trace_begin();
+		backend->vtable.flip(backend);
+		render_trace_end(trace, STRING_CONST("render_backend_flip"));
+	} else {
+		// Idle frames still age released resources, or the destroy queue never drains
+		++backend->framecount;
+	}
+	render_backend_destroy_queued(backend, false);
+	render_trace_frame();
+	return !idle;
+}
+
+/*! Number of flips before a released resource is destroyed. Commands for the next frame
+may be queued by other threads while the current frame is dispatched, so a resource
+released during frame N can be referenced until frame N+1 is dispatched, and the GPU can
+still be executing frame N+1 until frames_in_flight more frames are flipped */
+static uint64_t
+render_backend_destroy_latency(void) {
+	return 1 + (uint64_t)_render_config.frames_in_flight;
+}
+
+void
+render_backend_queue_destroy(render_backend_t* backend, render_destroy_t* entry,
+                             render_destroy_type_t type, void* object) {
+	// Entry is embedded in the resource, so releasing never allocates
+	entry->object = object;
+	entry->frame = backend->framecount;
+	entry->type = type;
+	// Consumer only ever takes the entire list, so a plain compare-and-swap push is ABA safe
+	do {
+		entry->next = atomic_loadptr(&backend->destroyqueue, memory_order_acquire);
+	} while (!atomic_cas_ptr(&backend->destroyqueue, entry, entry->next, memory_order_release,
+	                         memory_order_acquire));
+}
+
+static void
+render_backend_destroy_entry(render_destroy_t* entry) {
+	switch (entry->type) {
+		case RENDERDESTROY_BUFFER:
+			render_buffer_destroy(entry->object);
+			break;
+		case RENDERDESTROY_TEXTURE:
+			render_texture_destroy(entry->object);
+			break;
+		case RENDERDESTROY_SHADER:
+			render_shader_destroy(entry->object);
+			break;
+		case RENDERDESTROY_PROGRAM:
+			render_program_destroy(entry->object);
+			break;
+		case RENDERDESTROY_TARGET:
+			render_target_deallocate(entry->object);
+			break;
+	}
+}
+
+void
+render_backend_destroy_queued(render_backend_t* backend, bool force) {
+	// Destroying a resource can release other resources (program releasing shaders),
+	// so a forced drain loops until the queue is empty
+	uint64_t latency = render_backend_destroy_latency();
+	do {
+		render_destroy_t* entry;
+		do {
+			entry = atomic_loadptr(&backend->destroyqueue, memory_order_acquire);
+		} while (entry && !atomic_cas_ptr(&backend->destroyqueue, nullptr, entry,
+		                                  memory_order_release, memory_order_acquire));
+
+		while (entry) {
+			render_destroy_t* next = entry->next;
+			entry->next = backend->destroypending;
+			backend->destroypending = entry;
+			entry = next;
+		}
+
+		render_destroy_t** link = &backend->destroypending;
+		while (*link) {
+			entry = *link;
+			if (force || (backend->framecount >= entry->frame + latency)) {
+				*link = entry->next;
+				render_backend_destroy_entry(entry);
+			} else {
+				link = &entry->next;
+			}
+		}
+	} while (force && atomic_loadptr(&backend->destroyqueue, memory_order_acquire));
 }
 
 uint64_t
@@ -376,6 +982,31 @@ render_backend_set_max_concurrency(render_backend_t* backend, size_t num_threads
 	backend->concurrency = (uint64_t)num_threads;
 }
 
+void
+render_backend_set_skip_idle(render_backend_t* backend, bool enable) {
+	backend->skip_idle = enable;
+	backend->framebuffer.dispatch_hash = 0;
+	array_clear(backend->dispatch_slot_hash);
+}
+
+unsigned int
+render_backend_timer_begin(render_backend_t* backend) {
+	return backend->vtable.timer_begin ? backend->vtable.timer_begin(backend) : 0;
+}
+
+void
+render_backend_timer_end(render_backend_t* backend, unsigned int timer) {
+	if (timer && backend->vtable.timer_end)
+		backend->vtable.timer_end(backend, timer);
+}
+
+bool
+render_backend_timer_result(render_backend_t* backend, unsigned int timer, uint64_t* nanoseconds) {
+	if (!timer || !backend->vtable.timer_result)
+		return false;
+	return backend->vtable.timer_result(backend, timer, nanoseconds);
+}
+
 size_t
 render_backend_max_concurrency(render_backend_t* backend) {
 	return (size_t)backend->concurrency;
@@ -420,7 +1051,10 @@ render_backend_shader_upload(render_backend_t* backend, render_shader_t* shader,
 	if (shader->backend && (shader->backend != backend))
 		shader->backend->vtable.deallocate_shader(shader->backend, shader);
 	shader->backend = nullptr;
-	if (backend->vtable.upload_shader(backend, shader, buffer, size)) {
+	tick_t trace = render_trace_begin();
+	bool uploaded = backend->vtable.upload_shader(backend, shader, buffer, size);
+	render_trace_end(trace, STRING_CONST("render_backend_shader_upload"));
+	if (uploaded) {
 		shader->backend = backend;
 		return true;
 	}
@@ -432,7 +1066,10 @@ render_backend_program_upload(render_backend_t* backend, render_program_t* progr
 	if (program->backend && (program->backend != backend))
 		program->backend->vtable.deallocate_program(program->backend, program);
 	program->backend = nullptr;
-	if (backend->vtable.upload_program(backend, program)) {
+	tick_t trace = render_trace_begin();
+	bool uploaded = backend->vtable.upload_program(backend, program);
+	render_trace_end(trace, STRING_CONST("render_backend_program_upload"));
+	if (uploaded) {
 		program->backend = backend;
 		return true;
 	}
@@ -445,8 +1082,12 @@ render_backend_texture_upload(render_backend_t* backend, render_texture_t* textu
 	if (texture->backend && (texture->backend != backend))
 		texture->backend->vtable.deallocate_texture(texture->backend, texture);
 	texture->backend = nullptr;
-	if (backend->vtable.upload_texture(backend, texture, buffer, size)) {
+	tick_t trace = render_trace_begin();
+	bool uploaded = backend->vtable.upload_texture(backend, texture, buffer, size);
+	render_trace_end(trace, STRING_CONST("render_backend_texture_upload"));
+	if (uploaded) {
 		texture->backend = backend;
+		atomic_incr32(&backend->texture_generation, memory_order_release);
 		return true;
 	}
 	return false;
@@ -50,6 +50,40 @@ render_backend_set_format(render_backend_t* backend, const pixelformat_t format,
 RENDER_API void
 render_backend_set_max_concurrency(render_backend_t* backend, size_t num_threads);
 
+/*! Enable skipping of idle frames, dispatches repeating the command stream of the dispatch
+at the same position in the previous frame and flips of frames where every dispatch was
+skipped. Idle flips still advance the frame count. The back buffer is undefined after a
+flip, so frame buffer dispatches are only skipped when the entire frame is idle. Dispatches
+reading a target rendered later in the same frame are not detected as changed, since
+dispatch order is assumed to follow the data flow
+\param backend Backend
+\param enable true to skip idle frames, false to always dispatch and flip */
+RENDER_API void
+render_backend_set_skip_idle(render_backend_t* backend, bool enable);
+
+/*! Begin a GPU timer measuring the commands dispatched until the timer is ended. Timers
+may be nested and must be used from the thread dispatching to the backend
+\param backend Backend
+\return Timer, zero if GPU timers are not supported by the backend */
+RENDER_API unsigned int
+render_backend_timer_begin(render_backend_t* backend);
+
+/*! End a GPU timer
+\param backend Backend
+\param timer Timer */
+RENDER_API void
+render_backend_timer_end(render_backend_t* backend, unsigned int timer);
+
+/*! Collect the result of an ended GPU timer without waiting for the GPU. The timer is
+released once the result is collected and must not be used again
+\param backend Backend
+\param timer Timer
+\param nanoseconds Receives the GPU time in nanoseconds, null to release the timer
+                   without collecting the result
+\return true if the result was collected, false if not yet available */
+RENDER_API bool
+render_backend_timer_result(render_backend_t* backend, unsigned int timer, uint64_t* nanoseconds);
+
 RENDER_API bool
 render_backend_set_drawable(render_backend_t* backend, const render_drawable_t* drawable);
 
@@ -59,11 +93,101 @@ render_backend_drawable(render_backend_t* backend);
 RENDER_API render_target_t*
 render_backend_target_framebuffer(render_backend_t* backend);
 
+/*! Get backend statistics, counters are accumulated over the lifetime of the backend
+\param backend Backend
+\return Statistics */
+RENDER_API const render_backend_statistics_t*
+render_backend_statistics(render_backend_t* backend);
+
+/*! Get memory usage of a resource type and usage class. System memory is the local
+store of buffers, GPU memory is an estimate from buffer sizes, texture formats and
+target dimensions, excluding driver overhead and alignment
+\param backend Backend
+\param type Resource type
+\param usage Usage class
+\return Current usage and high-water marks */
+RENDER_API render_memory_usage_t
+render_backend_memory_usage(render_backend_t* backend, render_resource_type_t type,
+                            render_usage_t usage);
+
+/*! Get memory usage of a resource type across all usage classes. The high-water marks
+are the sum of the high-water marks of each usage class
+\param backend Backend
+\param type Resource type
+\return Current usage and high-water marks */
+RENDER_API render_memory_usage_t
+render_backend_memory_type_usage(render_backend_t* backend, render_resource_type_t type);
+
+/*! Get total memory usage of all resources
+\param backend Backend
+\return Current usage and high-water marks */
+RENDER_API render_memory_usage_t
+render_backend_memory_total(render_backend_t* backend);
+
+/*! Reset all high-water marks to the current usage
+\param backend Backend */
 RENDER_API void
+render_backend_memory_reset_peak(render_backend_t* backend);
+
+/*! Set memory budgets. The callback is called with the total usage when an allocation or
+upload takes total system or GPU memory usage over its budget, and again only after usage
+has dropped back within budget and crossed it once more. The callback runs on the thread
+doing the allocation or upload, which may be the render thread inside a dispatch
+\param backend Backend
+\param system_budget System memory budget in bytes, zero for unlimited
+\param gpu_budget GPU memory budget in bytes, zero for unlimited
+\param callback Callback, may be null
+\param userdata User data passed to callback */
+RENDER_API void
+render_backend_set_memory_budget(render_backend_t* backend, uint64_t system_budget,
+                                 uint64_t gpu_budget, render_memory_budget_fn callback,
+                                 void* userdata);
+
+/*! Dispatch sorted contexts to a target. If idle frame skipping is enabled and the sorted
+command stream, the referenced parameter buffer generations and state, and the target
+dimensions are unchanged since the dispatch at the same position in the previous frame, and
+no buffer was uploaded and no other dispatch executed earlier in the frame, the dispatch is
+skipped. A frame buffer dispatch is only skipped if it was the last dispatch of the
+previous frame, as later dispatches of the frame are not known yet. If a dispatch still
+executes after a skipped frame buffer dispatch, the frame is incomplete and the flip keeps
+the previous frame presented. Use render_pipeline_dispatch to skip frames with several
+frame buffer dispatches as a whole
+\param backend Backend
+\param target Target
+\param contexts Sorted contexts
+\param num_contexts Number of contexts
+\return true if dispatched, false if skipped as idle */
+RENDER_API bool
 render_backend_dispatch(render_backend_t* backend, render_target_t* target,
                         render_context_t** contexts, size_t num_contexts);
 
+/*! Dispatch the same sorted contexts once for each view. Render commands referencing one
+of the view parameter buffers use the matching parameter buffer of the view instead, so
+commands are recorded and sorted once for all views. The view rectangle is set as viewport
+before the contexts are dispatched, and viewport commands in the contexts are relative to
+the view rectangle
+\param backend Backend
+\param views Views
+\param num_views Number of views
+\param view_parameters Parameter buffers referenced by commands and substituted per view
+\param num_view_parameters Number of view parameter buffers, also the number of parameter
+buffers in each view
+\param contexts Sorted contexts
+\param num_contexts Number of contexts */
 RENDER_API void
+render_backend_dispatch_views(render_backend_t* backend, const render_view_t* views,
+                              size_t num_views, render_parameterbuffer_t** view_parameters,
+                              size_t num_view_parameters, render_context_t** contexts,
+                              size_t num_contexts);
+
+/*! Present the current frame. Buffers, textures, shaders and programs deallocated from
+any thread are queued and destroyed here once no frame in progress can reference them,
+so flip must be called on the thread owning the backend context. If every dispatch of the
+frame was skipped as idle, or a dispatch executed after a skipped frame buffer dispatch, the
+previous frame stays presented. The frame count is incremented for skipped flips as well
+\param backend Backend
+\return true if the frame was presented, false if skipped as idle */
+RENDER_API bool
 render_backend_flip(render_backend_t* backend);
 
 RENDER_API uint64_t
@@ -20,25 +20,310 @@
 #include <render/render.h>
 #include <render/internal.h>
 
+#include <resource/stream.h>
+
+#define RENDER_SPILL_HASH_BITS 12
+#define RENDER_SPILL_MIN_MATCH 4
+#define RENDER_SPILL_MAX_OFFSET 65535
+
+static uint8_t*
+render_buffer_spill_write_length(uint8_t* out, size_t length) {
+	while (length >= 255) {
+		*out++ = 255;
+		length -= 255;
+	}
+	*out++ = (uint8_t)length;
+	return out;
+}
+
+//! Byte oriented LZ compression of a buffer store, returns 0 if output does not fit in capacity
+static size_t
+render_buffer_spill_compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+	uint32_t table[1 << RENDER_SPILL_HASH_BITS];
+	const uint8_t* in = src;
+	const uint8_t* anchor = src;
+	const uint8_t* end = src + size;
+	const uint8_t* limit = (size > RENDER_SPILL_MIN_MATCH) ? end - RENDER_SPILL_MIN_MATCH : src;
+	uint8_t* out = dst;
+	uint8_t* out_end = dst + capacity;
+	size_t literals;
+	uint8_t* token;
+
+	memset(table, 0xFF, sizeof(table));
+
+	while (in < limit) {
+		uint32_t sequence;
+		memcpy(&sequence, in, sizeof(sequence));
+		uint32_t slot = (sequence * 2654435761U) >> (32 - RENDER_SPILL_HASH_BITS);
+		uint32_t ref = table[slot];
+		size_t pos = (size_t)(in - src);
+		table[slot] = (uint32_t)pos;
+		if ((ref == 0xFFFFFFFF) || ((pos - ref) > RENDER_SPILL_MAX_OFFSET) ||
+		    memcmp(src + ref, in, RENDER_SPILL_MIN_MATCH)) {
+			++in;
+			continue;
+		}
+
+		const uint8_t* match = src + ref;
+		size_t length = RENDER_SPILL_MIN_MATCH;
+		while (((in + length) < end) && (match[length] == in[length]))
+			++length;
+
+		literals = (size_t)(in - anchor);
+		size_t matchlen = length - RENDER_SPILL_MIN_MATCH;
+		if ((size_t)(out_end - out) < (literals + (literals / 255) + (matchlen / 255) + 5))
+			return 0;
+
+		token = out++;
+		*token = (uint8_t)(((literals >= 15) ? 15 : literals) << 4);
+		if (literals >= 15)
+			out = render_buffer_spill_write_length(out, literals - 15);
+		memcpy(out, anchor, literals);
+		out += literals;
+
+		size_t offset = (size_t)(in - match);
+		*out++ = (uint8_t)(offset & 0xFF);
+		*out++ = (uint8_t)(offset >> 8);
+
+		*token |= (uint8_t)((matchlen >= 15) ? 15 : matchlen);
+		if (matchlen >= 15)
+			out = render_buffer_spill_write_length(out, matchlen - 15);
+
+		in += length;
+		anchor = in;
+	}
+
+	// Final sequence is literals only
+	literals = (size_t)(end - anchor);
+	if ((size_t)(out_end - out) < (literals + (literals / 255) + 2))
+		return 0;
+	token = out++;
+	*token = (uint8_t)(((literals >= 15) ? 15 : literals) << 4);
+	if (literals >= 15)
+		out = render_buffer_spill_write_length(out, literals - 15);
+	memcpy(out, anchor, literals);
+	out += literals;
+
+	return (size_t)(out - dst);
+}
+
+static bool
+render_buffer_spill_read_length(const uint8_t** in, const uint8_t* end, size_t* length) {
+	uint8_t value;
+	do {
+		if (*in >= end)
+			return false;
+		value = *(*in)++;
+		*length += value;
+	} while (value == 255);
+	return true;
+}
+
+static bool
+render_buffer_spill_decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+	const uint8_t* in = src;
+	const uint8_t* end = src + size;
+	uint8_t* out = dst;
+	uint8_t* out_end = dst + capacity;
+
+	while (in < end) {
+		uint8_t token = *in++;
+		size_t literals = token >> 4;
+		if ((literals == 15) && !render_buffer_spill_read_length(&in, end, &literals))
+			return false;
+		if (((size_t)(end - in) < literals) || ((size_t)(out_end - out) < literals))
+			return false;
+		memcpy(out, in, literals);
+		in += literals;
+		out += literals;
+		if (in >= end)
+			break;
+
+		if ((end - in) < 2)
+			return false;
+		size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+		in += 2;
+		size_t length = token & 0x0F;
+		if ((length == 15) && !render_buffer_spill_read_length(&in, end, &length))
+			return false;
+		length += RENDER_SPILL_MIN_MATCH;
+		if (!offset || (offset > (size_t)(out - dst)) || ((size_t)(out_end - out) < length))
+			return false;
+
+		// Matches can overlap output, copy bytewise
+		const uint8_t* match = out - offset;
+		while (length--)
+			*out++ = *match++;
+	}
+
+	return out == out_end;
+}
+
+static void
+render_buffer_spill_release(render_buffer_backing_t* backing) {
+	memory_deallocate(backing->spill);
+	backing->spill = nullptr;
+	backing->spill_size = 0;
+}
+
+//! Store compressed copy of buffer data in spill cache, returns false if data is incompressible
+static bool
+render_buffer_spill(render_buffer_t* buffer) {
+	render_buffer_backing_t* backing = buffer->backing;
+	size_t capacity = buffer->buffersize - 1;
+	uint8_t* compressed = memory_allocate(HASH_RENDER, capacity, 0, MEMORY_TEMPORARY);
+	size_t size = render_buffer_spill_compress(buffer->store, buffer->buffersize, compressed, capacity);
+	if (size) {
+		backing->spill = memory_allocate(HASH_RENDER, size, 0, MEMORY_PERSISTENT);
+		backing->spill_size = size;
+		memcpy(backing->spill, compressed, size);
+	}
+	memory_deallocate(compressed);
+	return size > 0;
+}
+
+static bool
+render_buffer_read_source(render_buffer_t* buffer) {
+	render_buffer_backing_t* backing = buffer->backing;
+	uint64_t platform = render_backend_resource_platform(buffer->backend);
+	stream_t* stream = resource_stream_open_static(backing->source, platform);
+	if (!stream)
+		return false;
+	stream_seek(stream, (ssize_t)backing->offset, STREAM_SEEK_BEGIN);
+	size_t read = stream_read(stream, buffer->store, buffer->buffersize);
+	stream_deallocate(stream);
+	return (read == buffer->buffersize);
+}
+
+//! Drop system memory store, caller must hold buffer lock or otherwise guarantee exclusive access
+static void
+render_buffer_discard_store(render_buffer_t* buffer) {
+	render_buffer_backing_t* backing = buffer->backing;
+	if (!backing || !buffer->store || !buffer->buffersize)
+		return;
+
+	if (uuid_is_null(backing->source) && !backing->spill && !render_buffer_spill(buffer)) {
+		// A raw copy would save no memory, keep the store and stop trying
+		log_warn(HASH_RENDER, WARNING_SUSPICIOUS,
+		         STRING_CONST("Incompressible buffer data without source, keeping system store"));
+		buffer->flags &= ~(uint32_t)RENDERBUFFER_DISCARD;
+		return;
+	}
+
+	buffer->backend->vtable.deallocate_buffer(buffer->backend, buffer, true, false);
+	buffer->store = nullptr;
+	buffer->flags |= RENDERBUFFER_DISCARDED;
+}
+
+//! Restore dropped system memory store, caller must hold buffer lock
+static void
+render_buffer_restore_store(render_buffer_t* buffer) {
+	render_buffer_backing_t* backing = buffer->backing;
+	bool restored = false;
+
+	buffer->store = buffer->backend->vtable.allocate_buffer(buffer->backend, buffer);
+	buffer->flags &= ~(uint32_t)RENDERBUFFER_DISCARDED;
+
+	if (backing->spill) {
+		restored = render_buffer_spill_decompress(backing->spill, backing->spill_size,
+		                                          buffer->store, buffer->buffersize);
+	} else if (!uuid_is_null(backing->source)) {
+		restored = render_buffer_read_source(buffer);
+	}
+
+	if (!restored) {
+		log_error(HASH_RENDER, ERROR_INTERNAL_FAILURE,
+		          STRING_CONST("Unable to restore discarded buffer data"));
+		memset(buffer->store, 0, buffer->buffersize);
+	}
+}
+
+static bool
+render_buffer_should_discard(render_buffer_t* buffer) {
+	return ((buffer->flags & (RENDERBUFFER_DISCARD | RENDERBUFFER_DIRTY | RENDERBUFFER_DISCARDED)) ==
+	        RENDERBUFFER_DISCARD) &&
+	       !buffer->locks;
+}
+
+static atomic32_t render_buffer_generation_counter;
+
+uint32_t
+render_buffer_generation(void) {
+	// Unique across buffers, so a buffer reallocated at the same address never
+	// matches a generation recorded for the previous buffer
+	return (uint32_t)atomic_incr32(&render_buffer_generation_counter, memory_order_relaxed);
+}
+
 void
 render_buffer_deallocate(render_buffer_t* buffer) {
-	if (buffer) {
-		buffer->backend->vtable.deallocate_buffer(buffer->backend, buffer, true, true);
-		semaphore_finalize(&buffer->lock);
-		memory_deallocate(buffer);
+	if (buffer)
+		render_backend_queue_destroy(buffer->backend, &buffer->destroy, RENDERDESTROY_BUFFER,
+		                             buffer);
+}
+
+void
+render_buffer_destroy(render_buffer_t* buffer) {
+	buffer->backend->vtable.deallocate_buffer(buffer->backend, buffer, true, true);
+	if (buffer->backing) {
+		render_buffer_spill_release(buffer->backing);
+		memory_deallocate(buffer->backing);
+	}
+	semaphore_finalize(&buffer->lock);
+	render_pool_deallocate(&_render_buffer_pool, buffer);
+}
+
+static void
+render_buffer_upload_store(render_buffer_t* buffer) {
+	if (buffer->flags & RENDERBUFFER_DIRTY) {
+		tick_t trace = render_trace_begin();
+		buffer->backend->vtable.upload_buffer(buffer->backend, (render_buffer_t*)buffer);
+		render_trace_end(trace, STRING_CONST("render_buffer_upload"));
 	}
 }
 
+//! Drop system memory store if requested, called without holding buffer lock. Skipped if the
+//! buffer is concurrently locked, and retried on the next upload
+static void
+render_buffer_try_discard(render_buffer_t* buffer) {
+	if (!(buffer->flags & RENDERBUFFER_DISCARD) || !semaphore_try_wait(&buffer->lock, 0))
+		return;
+	if (render_buffer_should_discard(buffer))
+		render_buffer_discard_store(buffer);
+	semaphore_post(&buffer->lock);
+}
+
 void
 render_buffer_upload(render_buffer_t* buffer) {
-	if (buffer->flags & RENDERBUFFER_DIRTY)
-		buffer->backend->vtable.upload_buffer(buffer->backend, (render_buffer_t*)buffer);
+	render_buffer_upload_store(buffer);
+	render_buffer_try_discard(buffer);
+}
+
+void
+render_buffer_upload_batch(render_backend_t* backend, render_buffer_t** buffers, size_t num_buffers) {
+	tick_t trace = render_trace_begin();
+	if (backend->vtable.upload_buffers) {
+		backend->vtable.upload_buffers(backend, buffers, num_buffers);
+	} else {
+		for (size_t ibuf = 0; ibuf < num_buffers; ++ibuf)
+			backend->vtable.upload_buffer(backend, buffers[ibuf]);
+	}
+	render_trace_end(trace, STRING_CONST("render_buffer_upload_batch"));
+
+	for (size_t ibuf = 0; ibuf < num_buffers; ++ibuf)
+		render_buffer_try_discard(buffers[ibuf]);
 }
 
 void
 render_buffer_lock(render_buffer_t* buffer, unsigned int lock) {
 	semaphore_wait(&buffer->lock);
 	{
+		if (buffer->flags & RENDERBUFFER_DISCARDED)
+			render_buffer_restore_store(buffer);
+		if ((lock & RENDERBUFFER_LOCK_WRITE) && buffer->backing) {
+			// Data will no longer match source resource or spill cache
+			buffer->backing->source = uuid_null();
+			render_buffer_spill_release(buffer->backing);
+		}
 		buffer->locks++;
 		buffer->access = buffer->store;
 		buffer->flags |= (lock & RENDERBUFFER_LOCK_BITS);
@@ -54,15 +339,74 @@ render_buffer_unlock(render_buffer_t* buffer) {
 			--buffer->locks;
 			if (!buffer->locks) {
 				buffer->access = nullptr;
+				if ((buffer->flags & RENDERBUFFER_LOCK_WRITE) &&
+				    (buffer->buffertype == RENDERBUFFER_PARAMETER))
+					((render_parameterbuffer_t*)buffer)->generation = render_buffer_generation();
 				if ((buffer->flags & RENDERBUFFER_LOCK_WRITE) && !(buffer->flags & RENDERBUFFER_LOCK_NOUPLOAD)) {
 					buffer->flags |= RENDERBUFFER_DIRTY;
 					if ((buffer->policy == RENDERBUFFER_UPLOAD_ONUNLOCK) ||
 					        (buffer->flags & RENDERBUFFER_LOCK_FORCEUPLOAD))
-						render_buffer_upload(buffer);
+						render_buffer_upload_store(buffer);
 				}
 				buffer->flags &= ~(uint32_t)RENDERBUFFER_LOCK_BITS;
+				if (render_buffer_should_discard(buffer))
+					render_buffer_discard_store(buffer);
 			}
 		}
 	}
 	semaphore_post(&buffer->lock);
 }
+
+void
+render_buffer_set_discard(render_buffer_t* buffer, const uuid_t source, size_t offset) {
+	// Parameter buffers are read from system memory at dispatch and must keep their store
+	if ((buffer->usage != RENDERUSAGE_STATIC) ||
+	    !(buffer->buffertype & (RENDERBUFFER_VERTEX | RENDERBUFFER_INDEX))) {
+		log_warn(HASH_RENDER, WARNING_INVALID_VALUE,
+		         STRING_CONST("Only static vertex and index buffers can discard system memory store"));
+		return;
+	}
+
+	semaphore_wait(&buffer->lock);
+	{
+		if (!buffer->backing)
+			buffer->backing = memory_allocate(HASH_RENDER, sizeof(render_buffer_backing_t), 0,
+			                                  MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		buffer->backing->source = source;
+		buffer->backing->offset = offset;
+		buffer->flags |= RENDERBUFFER_DISCARD;
+		if (render_buffer_should_discard(buffer))
+			render_buffer_discard_store(buffer);
+	}
+	semaphore_post(&buffer->lock);
+}
+
+void
+render_buffer_free(render_buffer_t* buffer, bool sys, bool aux) {
+	semaphore_wait(&buffer->lock);
+	{
+		if (sys && (buffer->flags & RENDERBUFFER_DISCARD)) {
+			// Keep data recoverable through source resource or spill cache, unless the
+			// discard was refused for incompressible data
+			render_buffer_discard_store(buffer);
+			sys = !(buffer->flags & RENDERBUFFER_DISCARDED);
+		}
+		buffer->backend->vtable.deallocate_buffer(buffer->backend, buffer, sys, aux);
+		if (sys)
+			buffer->store = nullptr;
+	}
+	semaphore_post(&buffer->lock);
+}
+
+void
+render_buffer_restore(render_buffer_t* buffer) {
+	semaphore_wait(&buffer->lock);
+	{
+		if (buffer->flags & RENDERBUFFER_DISCARDED)
+			render_buffer_restore_store(buffer);
+		else if (!buffer->store)
+			buffer->store = buffer->backend->vtable.allocate_buffer(buffer->backend, buffer);
+		buffer->flags |= RENDERBUFFER_DIRTY;
+	}
+	semaphore_post(&buffer->lock);
+}
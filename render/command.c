@@ -54,16 +54,75 @@ render_command_viewport(render_command_t* command, unsigned int x, unsigned int
 	command->data.viewport.max_z    = max_z;
 }
 
+void
+render_command_blit(render_command_t* command, render_target_t* source, unsigned int source_x,
+                    unsigned int source_y, unsigned int source_width, unsigned int source_height,
+                    unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                    unsigned int buffer_mask) {
+	command->type                    = RENDERCOMMAND_BLIT;
+	command->data.blit.source        = source;
+	command->data.blit.source_x      = (int)source_x;
+	command->data.blit.source_y      = (int)source_y;
+	command->data.blit.source_width  = (int)source_width;
+	command->data.blit.source_height = (int)source_height;
+	command->data.blit.x             = (int)x;
+	command->data.blit.y             = (int)y;
+	command->data.blit.width         = (int)width;
+	command->data.blit.height        = (int)height;
+	command->data.blit.buffer_mask   = buffer_mask;
+}
+
 void
 render_command_render(render_command_t* command, render_primitive_t type, size_t num,
                       render_program_t* program, render_vertexbuffer_t* vertexbuffer,
                       render_indexbuffer_t* indexbuffer, render_parameterbuffer_t* parameterbuffer,
                       render_statebuffer_t* statebuffer) {
-	command->type                         = RENDERCOMMAND_RENDER_TRIANGLELIST + (type - 1);
-	command->count                        = (unsigned int)num;
-	command->data.render.program          = program;
-	command->data.render.vertexbuffer     = vertexbuffer;
-	command->data.render.indexbuffer      = indexbuffer;
-	command->data.render.parameterbuffer  = parameterbuffer;
-	command->data.render.statebuffer      = statebuffer;
+	command->type                               = RENDERCOMMAND_RENDER_TRIANGLELIST + (type - 1);
+	command->count                              = (unsigned int)num;
+	command->data.render.program                = program;
+	command->data.render.vertexbuffer           = vertexbuffer;
+	command->data.render.indexbuffer            = indexbuffer;
+	command->data.render.parameterbuffer        = parameterbuffer;
+	command->data.render.statebuffer            = statebuffer;
+	command->data.render.program_handle         = render_program_handle(program);
+	command->data.render.vertexbuffer_handle    = render_buffer_handle(vertexbuffer);
+	command->data.render.indexbuffer_handle     = render_buffer_handle(indexbuffer);
+	command->data.render.parameterbuffer_handle = render_buffer_handle(parameterbuffer);
+	command->data.render.statebuffer_handle     = render_buffer_handle(statebuffer);
+	memset(command->data.render.vertexstream, 0, sizeof(command->data.render.vertexstream));
+	memset(command->data.render.vertexstream_handle, 0,
+	       sizeof(command->data.render.vertexstream_handle));
+	command->data.render.palettebuffer        = nullptr;
+	command->data.render.palettebuffer_handle = 0;
+	command->data.render.palette_offset       = 0;
+	command->data.render.depth                = 0;
+}
+
+void
+render_command_render_streams(render_command_t* command, render_primitive_t type, size_t num,
+                              render_program_t* program, render_vertexbuffer_t** vertexbuffers,
+                              size_t num_vertexbuffers, render_indexbuffer_t* indexbuffer,
+                              render_parameterbuffer_t* parameterbuffer,
+                              render_statebuffer_t* statebuffer) {
+	FOUNDATION_ASSERT(num_vertexbuffers && (num_vertexbuffers <= RENDER_MAX_VERTEX_BINDINGS));
+	render_command_render(command, type, num, program, vertexbuffers[0], indexbuffer,
+	                      parameterbuffer, statebuffer);
+	for (size_t ibuf = 1; ibuf < num_vertexbuffers; ++ibuf) {
+		render_vertexbuffer_t* vertexbuffer = vertexbuffers[ibuf];
+		command->data.render.vertexstream[ibuf - 1]        = vertexbuffer;
+		command->data.render.vertexstream_handle[ibuf - 1] = render_buffer_handle(vertexbuffer);
+	}
+}
+
+void
+render_command_set_palette(render_command_t* command, render_palettebuffer_t* palettebuffer,
+                           unsigned int offset) {
+	command->data.render.palettebuffer        = palettebuffer;
+	command->data.render.palettebuffer_handle = render_buffer_handle(palettebuffer);
+	command->data.render.palette_offset       = offset;
+}
+
+void
+render_command_set_depth(render_command_t* command, float32_t depth) {
+	command->data.render.depth = depth;
 }
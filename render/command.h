@@ -38,9 +38,66 @@ RENDER_API void
 render_command_viewport(render_command_t* command, unsigned int x, unsigned int y,
                         unsigned int width, unsigned int height, real min_z, real max_z);
 
+/*! Copy a rectangle of a source target to the dispatched target. Rectangles of different
+size scale the source, linearly filtered if only color is copied. A multisampled source is
+resolved, in which case the rectangles must have the same size
+\param command Command
+\param source Source target
+\param source_x Source rectangle x
+\param source_y Source rectangle y
+\param source_width Source rectangle width, zero for the full source target
+\param source_height Source rectangle height, zero for the full source target
+\param x Destination rectangle x
+\param y Destination rectangle y
+\param width Destination rectangle width, zero for the full destination target
+\param height Destination rectangle height, zero for the full destination target
+\param buffer_mask Buffers to copy, combination of RENDERBUFFER_COLOR, RENDERBUFFER_DEPTH
+                   and RENDERBUFFER_STENCIL */
+RENDER_API void
+render_command_blit(render_command_t* command, render_target_t* source, unsigned int source_x,
+                    unsigned int source_y, unsigned int source_width, unsigned int source_height,
+                    unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                    unsigned int buffer_mask);
+
 RENDER_API void
 render_command_render(render_command_t* command, render_primitive_t type, size_t num,
                       render_program_t* program, render_vertexbuffer_t* vertexbuffer,
                       render_indexbuffer_t* indexbuffer, render_parameterbuffer_t* parameterbuffer,
                       render_statebuffer_t* statebuffer);
 
+/*! Render primitives fetching vertex attributes from multiple vertex buffers. The vertex
+declaration of the first buffer defines the layout, attributes with binding N are fetched
+from vertex buffer N. Attributes whose binding slot has no buffer are disabled, which
+allows for example a depth only pass to fetch a position only stream.
+\param command Command
+\param type Primitive type
+\param num Number of primitives
+\param program Program
+\param vertexbuffers Vertex buffers, one per binding slot
+\param num_vertexbuffers Number of vertex buffers (1 to RENDER_MAX_VERTEX_BINDINGS)
+\param indexbuffer Index buffer
+\param parameterbuffer Parameter buffer
+\param statebuffer State buffer */
+RENDER_API void
+render_command_render_streams(render_command_t* command, render_primitive_t type, size_t num,
+                              render_program_t* program, render_vertexbuffer_t** vertexbuffers,
+                              size_t num_vertexbuffers, render_indexbuffer_t* indexbuffer,
+                              render_parameterbuffer_t* parameterbuffer,
+                              render_statebuffer_t* statebuffer);
+
+/*! Set the matrix palette of a render command, must be called after the command is
+initialized with render_command_render or render_command_render_streams
+\param command Command
+\param palettebuffer Palette buffer
+\param offset Offset of first bone matrix, as returned by render_palettebuffer_append */
+RENDER_API void
+render_command_set_palette(render_command_t* command, render_palettebuffer_t* palettebuffer,
+                           unsigned int offset);
+
+/*! Set the view space depth of a render command, used to sort derived depth pre-pass
+commands front to back. Must be called after the command is initialized with
+render_command_render or render_command_render_streams, depth is zero if not set
+\param command Command
+\param depth View space depth, positive distance from viewer */
+RENDER_API void
+render_command_set_depth(render_command_t* command, float32_t depth);
@@ -33,6 +33,8 @@ render_compile(const uuid_t uuid, uint64_t platform, resource_source_t* source,
 		return 0;
 	if (render_program_compile(uuid, platform, source, source_hash, type, type_length) == 0)
 		return 0;
+	if (render_mesh_compile(uuid, platform, source, source_hash, type, type_length) == 0)
+		return 0;
 	return -1;
 }
 
@@ -449,6 +451,10 @@ render_program_compile_opengl(render_backend_t* backend, uuid_t vertexshader, uu
 				binding = VERTEXATTRIBUTE_TEXCOORD0;
 			else if (string_equal(name, (size_t)num_chars, STRING_CONST("tangent")))
 				binding = VERTEXATTRIBUTE_TANGENT;
+			else if (string_equal(name, (size_t)num_chars, STRING_CONST("weight")))
+				binding = VERTEXATTRIBUTE_WEIGHT;
+			else if (string_equal(name, (size_t)num_chars, STRING_CONST("index")))
+				binding = VERTEXATTRIBUTE_INDEX;
 			glBindAttribLocation(handle, binding, name);
 		}
 	}
@@ -497,6 +503,10 @@ render_program_compile_opengl(render_backend_t* backend, uuid_t vertexshader, uu
 			attrib = VERTEXATTRIBUTE_TEXCOORD0;
 		else if (string_equal(name, (size_t)num_chars, STRING_CONST("tangent")))
 			attrib = VERTEXATTRIBUTE_TANGENT;
+		else if (string_equal(name, (size_t)num_chars, STRING_CONST("weight")))
+			attrib = VERTEXATTRIBUTE_WEIGHT;
+		else if (string_equal(name, (size_t)num_chars, STRING_CONST("index")))
+			attrib = VERTEXATTRIBUTE_INDEX;
 		else {
 			log_errorf(HASH_RESOURCE, ERROR_SYSTEM_CALL_FAIL,
 			           STRING_CONST("Invalid/unknown attribute name: %.*s"), (int)num_chars, name);
@@ -548,11 +558,12 @@ render_program_compile_opengl(render_backend_t* backend, uuid_t vertexshader, uu
 		goto exit;
 
 	offset = 0;
+	program->num_parameters = 0;
 	for (GLint iu = 0; (iu < uniforms) && compiled; ++iu) {
 		GLsizei num_chars = 0;
 		GLint size = 0;
 		GLenum gltype = GL_NONE;
-		render_parameter_t* parameter = program->parameters + iu;
+		render_parameter_t* parameter = program->parameters + program->num_parameters;
 
 		glGetActiveUniform(handle, (GLuint)iu, sizeof(name), &num_chars, &size, &gltype, name);
 		size_t bracket_pos = string_find(name, num_chars, '[', 0);
@@ -561,12 +572,25 @@ render_program_compile_opengl(render_backend_t* backend, uuid_t vertexshader, uu
 			num_chars = (GLsizei)bracket_pos;
 		}
 
+		// Palette offset is set by the backend from the render command
+		if (string_equal(name, (size_t)num_chars, STRING_CONST("palette_offset")))
+			continue;
+		++program->num_parameters;
+
 		parameter->name = hash(name, (size_t)num_chars);
 		parameter->location = (unsigned int)glGetUniformLocation(handle, name);
 		parameter->dim = (uint16_t)size;
 		parameter->offset = offset;
 		parameter->stages = SHADER_VERTEX | SHADER_PIXEL;
 
+		// Palette is sourced from the palette buffer of the render command, as a
+		// texture buffer (GL4) or a matrix array (GL2) and has no parameter data
+		if (string_equal(name, (size_t)num_chars, STRING_CONST("palette")) &&
+		    ((gltype == GL_FLOAT_MAT4) || (gltype == 0x8DC2))) {  // GL_SAMPLER_BUFFER
+			parameter->type = RENDERPARAMETER_PALETTE;
+			continue;
+		}
+
 		switch (gltype) {
 			case GL_FLOAT_VEC4:
 				parameter->type = RENDERPARAMETER_FLOAT4;
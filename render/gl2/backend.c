@@ -279,27 +279,33 @@ _rb_gl2_set_drawable(render_backend_t* backend, const render_drawable_t* drawabl
 static void*
 _rb_gl2_allocate_buffer(render_backend_t* backend, render_buffer_t* buffer) {
 	FOUNDATION_UNUSED(backend);
+	render_backend_memory_track_buffer(buffer, (int64_t)buffer->buffersize, 0);
 	return memory_allocate(HASH_RENDER, buffer->buffersize, 16, MEMORY_PERSISTENT);
 }
 
 static void
 _rb_gl2_deallocate_buffer(render_backend_t* backend, render_buffer_t* buffer, bool sys, bool aux) {
 	FOUNDATION_UNUSED(backend);
-	if (sys)
+	// State buffer store is embedded in the buffer
+	if (sys && buffer->store && (buffer->buffertype != RENDERBUFFER_STATE)) {
 		memory_deallocate(buffer->store);
+		render_backend_memory_track_buffer(buffer, -(int64_t)buffer->buffersize, 0);
+	}
 
 	if (aux && buffer->backend_data[0]) {
 		GLuint buffer_object = (GLuint)buffer->backend_data[0];
 		glDeleteBuffers(1, &buffer_object);
 		buffer->backend_data[0] = 0;
+		render_backend_memory_track_buffer(buffer, 0, -(int64_t)buffer->buffersize);
 	}
 }
 
 static bool
 _rb_gl2_upload_buffer(render_backend_t* backend, render_buffer_t* buffer) {
 	FOUNDATION_UNUSED(backend);
+	// Palettes are uploaded as uniform arrays from system memory at draw time
 	if ((buffer->buffertype == RENDERBUFFER_PARAMETER) ||
-	    (buffer->buffertype == RENDERBUFFER_STATE))
+	    (buffer->buffertype == RENDERBUFFER_STATE) || (buffer->buffertype == RENDERBUFFER_PALETTE))
 		return true;
 
 	GLuint buffer_object = (GLuint)buffer->backend_data[0];
@@ -308,6 +314,7 @@ _rb_gl2_upload_buffer(render_backend_t* backend, render_buffer_t* buffer) {
 		if (_rb_gl_check_error("Unable to create buffer object"))
 			return false;
 		buffer->backend_data[0] = buffer_object;
+		render_backend_memory_track_buffer(buffer, 0, (int64_t)buffer->buffersize);
 	}
 
 	glBindBuffer(GL_ARRAY_BUFFER, buffer_object);
@@ -483,6 +490,9 @@ _rb_gl2_upload_program(render_backend_t* backend, render_program_t* program) {
 	}
 
 	program->backend_data[0] = handle;
+	// Uniform values of a newly linked program are reset
+	program->backend_data[1] = 0;
+	program->backend_data[2] = 0;
 
 	return true;
 }
@@ -545,6 +555,10 @@ _rb_gl2_viewport(render_backend_gl2_t* backend, render_target_t* target, render_
 	GLint y = (GLint)command->data.viewport.y;
 	GLsizei w = (GLsizei)command->data.viewport.width;
 	GLsizei h = (GLsizei)command->data.viewport.height;
+	if (backend->view && backend->view->width && backend->view->height) {
+		x += (GLint)backend->view->x;
+		y += (GLint)backend->view->y;
+	}
 
 	glViewport(x, y, w, h);
 	glScissor(x, y, w, h);
@@ -553,14 +567,18 @@ _rb_gl2_viewport(render_backend_gl2_t* backend, render_target_t* target, render_
 	    (x || y || (w != (GLsizei)target->width) || (h != (GLsizei)target->height));
 }
 
-static const GLint _rb_gl2_vertex_format_size[VERTEXFORMAT_NUMTYPES] = {1, 2, 3, 4, 4, 4,
-                                                                        1, 2, 4, 1, 2, 4};
+static const GLint _rb_gl2_vertex_format_size[VERTEXFORMAT_NUMTYPES] = {
+    1, 2, 3, 4, 4, 4, 1, 2, 4, 1, 2, 4, 2, 4, 2, 4, 2, 4, 4};
 static const GLenum _rb_gl2_vertex_format_type[VERTEXFORMAT_NUMTYPES] = {
-    GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_UNSIGNED_BYTE, GL_BYTE,
-    GL_SHORT, GL_SHORT, GL_SHORT, GL_INT,   GL_INT,           GL_INT};
+    GL_FLOAT,          GL_FLOAT,         GL_FLOAT,          GL_FLOAT,
+    GL_UNSIGNED_BYTE,  GL_BYTE,          GL_SHORT,          GL_SHORT,
+    GL_SHORT,          GL_INT,           GL_INT,            GL_INT,
+    GL_HALF_FLOAT,     GL_HALF_FLOAT,    GL_SHORT,          GL_SHORT,
+    GL_UNSIGNED_SHORT, GL_UNSIGNED_SHORT, GL_INT_2_10_10_10_REV};
 static const GLboolean _rb_gl2_vertex_format_norm[VERTEXFORMAT_NUMTYPES] = {
-    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE,  GL_TRUE,
-    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE};
+    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE, GL_TRUE, GL_FALSE,
+    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE,
+    GL_TRUE,  GL_TRUE,  GL_TRUE,  GL_TRUE,  GL_TRUE};
 
 static const GLenum _rb_gl2_primitive_type[RENDERPRIMITIVE_NUMTYPES] = {GL_TRIANGLES, GL_TRIANGLES,
                                                                         GL_LINES};
@@ -581,9 +599,13 @@ static const GLenum _rb_gl2_index_format_type[INDEXFORMAT_NUMTYPES] = {
 // GL_ONE_MINUS_SRC_ALPHA, GL_DST_ALPHA,    GL_ONE_MINUS_DST_ALPHA, GL_CONSTANT_ALPHA,
 // GL_ONE_MINUS_CONSTANT_ALPHA, GL_SRC_ALPHA_SATURATE };
 
+static const GLenum _rb_gl2_cmp_func[] = {GL_NEVER,    GL_LESS,   GL_LEQUAL,  GL_EQUAL,
+                                          GL_NOTEQUAL, GL_GEQUAL, GL_GREATER, GL_ALWAYS};
+
 static void
 _rb_gl2_set_default_state(void) {
 	glBlendFunc(GL_ONE, GL_ZERO);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 	glDepthFunc(GL_LEQUAL);
 	glDepthMask(GL_TRUE);
 	glEnable(GL_DEPTH_TEST);
@@ -593,8 +615,12 @@ _rb_gl2_set_default_state(void) {
 
 static void
 _rb_gl2_set_state(render_state_t* state) {
-	FOUNDATION_UNUSED(state);
+	// Only depth and color write state is applied, blending is left at default
 	_rb_gl2_set_default_state();
+	GLboolean color_write = state->target_write[0] ? GL_TRUE : GL_FALSE;
+	glColorMask(color_write, color_write, color_write, color_write);
+	glDepthFunc(_rb_gl2_cmp_func[state->depth_func]);
+	glDepthMask(state->depth_write ? GL_TRUE : GL_FALSE);
 }
 
 static void
@@ -602,7 +628,8 @@ _rb_gl2_render(render_backend_gl2_t* backend, render_context_t* context,
                render_command_t* command) {
 	render_vertexbuffer_t* vertexbuffer = command->data.render.vertexbuffer;
 	render_indexbuffer_t* indexbuffer = command->data.render.indexbuffer;
-	render_parameterbuffer_t* parameterbuffer = command->data.render.parameterbuffer;
+	render_parameterbuffer_t* parameterbuffer =
+	    render_backend_command_parameterbuffer((render_backend_t*)backend, command);
 	render_program_t* program = command->data.render.program;
 	FOUNDATION_UNUSED(context);
 
@@ -612,17 +639,34 @@ _rb_gl2_render(render_backend_gl2_t* backend, render_context_t* context,
 	}
 
 	if (vertexbuffer->flags & RENDERBUFFER_DIRTY)
-		_rb_gl2_upload_buffer((render_backend_t*)backend, (render_buffer_t*)vertexbuffer);
+		render_buffer_upload((render_buffer_t*)vertexbuffer);
 	if (indexbuffer->flags & RENDERBUFFER_DIRTY)
-		_rb_gl2_upload_buffer((render_backend_t*)backend, (render_buffer_t*)indexbuffer);
-
-	// Bind vertex attributes
-	glBindBuffer(GL_ARRAY_BUFFER, (GLuint)vertexbuffer->backend_data[0]);
+		render_buffer_upload((render_buffer_t*)indexbuffer);
+
+	// Bind vertex attributes, attributes in binding slot N are sourced from vertex stream N
+	GLuint buffer_object[RENDER_MAX_VERTEX_BINDINGS];
+	buffer_object[0] = (GLuint)vertexbuffer->backend_data[0];
+	for (unsigned int istream = 1; istream < RENDER_MAX_VERTEX_BINDINGS; ++istream) {
+		render_vertexbuffer_t* streambuffer = command->data.render.vertexstream[istream - 1];
+		buffer_object[istream] = 0;
+		if (streambuffer) {
+			if (streambuffer->flags & RENDERBUFFER_DIRTY)
+				render_buffer_upload((render_buffer_t*)streambuffer);
+			buffer_object[istream] = (GLuint)streambuffer->backend_data[0];
+		}
+	}
 
+	GLuint bound_buffer = 0;
 	const render_vertex_decl_t* decl = &vertexbuffer->decl;
 	for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
 		const uint8_t format = decl->attribute[attrib].format;
-		if (format < VERTEXFORMAT_NUMTYPES) {
+		const unsigned int binding = decl->attribute[attrib].binding;
+		if ((format < VERTEXFORMAT_NUMTYPES) && (binding < RENDER_MAX_VERTEX_BINDINGS) &&
+		    buffer_object[binding]) {
+			if (bound_buffer != buffer_object[binding]) {
+				bound_buffer = buffer_object[binding];
+				glBindBuffer(GL_ARRAY_BUFFER, bound_buffer);
+			}
 			glVertexAttribPointer(
 			    attrib, _rb_gl2_vertex_format_size[format], _rb_gl2_vertex_format_type[format],
 			    _rb_gl2_vertex_format_norm[format], (GLsizei)decl->attribute[attrib].stride,
@@ -639,7 +683,19 @@ _rb_gl2_render(render_backend_gl2_t* backend, render_context_t* context,
 	// Bind programs/shaders
 	glUseProgram((GLuint)program->backend_data[0]);
 
-	// Bind the parameter blocks
+	// Bind the parameter blocks. Uniform values are program state and are only uploaded
+	// if the program has not already received this generation of the parameter buffer,
+	// textures are context state and always bound
+	bool upload = (program->backend_data[1] != (uintptr_t)parameterbuffer) ||
+	              (program->backend_data[2] != parameterbuffer->generation);
+	if (upload) {
+		program->backend_data[1] = (uintptr_t)parameterbuffer;
+		program->backend_data[2] = parameterbuffer->generation;
+		++backend->statistics.parameter_uploads;
+	} else {
+		++backend->statistics.parameter_skips;
+	}
+
 	GLuint unit = 0;
 	render_parameter_t* param = parameterbuffer->parameters;
 	for (unsigned int ip = 0; ip < parameterbuffer->parameter_count; ++ip, ++param) {
@@ -648,8 +704,22 @@ _rb_gl2_render(render_backend_gl2_t* backend, render_context_t* context,
 			glActiveTexture(GL_TEXTURE0 + unit);
 			glEnable(GL_TEXTURE_2D);
 			glBindTexture(GL_TEXTURE_2D, *(GLuint*)data);
-			glUniform1i((GLint)param->location, (GLint)unit);
+			if (upload)
+				glUniform1i((GLint)param->location, (GLint)unit);
 			++unit;
+		} else if (param->type == RENDERPARAMETER_PALETTE) {
+			// Palette contents and offset change per draw, always uploaded
+			render_palettebuffer_t* palettebuffer = command->data.render.palettebuffer;
+			size_t offset = command->data.render.palette_offset;
+			if (!palettebuffer || !palettebuffer->store || (offset >= palettebuffer->allocated))
+				continue;
+			size_t count = palettebuffer->allocated - offset;
+			if (count > param->dim)
+				count = param->dim;
+			glUniformMatrix4fv((GLint)param->location, (GLsizei)count, GL_FALSE,
+			                   pointer_offset(palettebuffer->store, offset * sizeof(float32_t) * 16));
+		} else if (!upload) {
+			continue;
 		} else if (param->type == RENDERPARAMETER_FLOAT4) {
 			glUniform4fv((GLint)param->location, param->dim, data);
 		} else if (param->type == RENDERPARAMETER_INT4) {
@@ -657,6 +727,8 @@ _rb_gl2_render(render_backend_gl2_t* backend, render_context_t* context,
 		} else if (param->type == RENDERPARAMETER_MATRIX) {
 			// Matrix math is row-major, must be transposed to match GL layout which is column major
 			glUniformMatrix4fv((GLint)param->location, param->dim, GL_TRUE, data);
+		} else if (param->type == RENDERPARAMETER_MATRIX_COLUMN) {
+			glUniformMatrix4fv((GLint)param->location, param->dim, GL_FALSE, data);
 		}
 	}
 
@@ -697,6 +769,10 @@ _rb_gl2_dispatch_command(render_backend_gl2_t* backend, render_target_t* target,
 			_rb_gl2_viewport(backend, target, context, command);
 			break;
 
+		case RENDERCOMMAND_BLIT:
+			_rb_gl_blit_target((render_backend_t*)backend, target, command);
+			break;
+
 		case RENDERCOMMAND_RENDER_TRIANGLELIST:
 		case RENDERCOMMAND_RENDER_LINELIST:
 			_rb_gl2_render(backend, context, command);
@@ -712,6 +788,14 @@ _rb_gl2_dispatch(render_backend_t* backend, render_target_t* target, render_cont
 	if (!_rb_gl_activate_target(backend, target))
 		return;
 
+	// A view without size covers the entire target, reset any viewport set by a previous view
+	const render_view_t* view = backend->view;
+	bool use_view = view && view->width && view->height;
+	render_command_t viewport;
+	render_command_viewport(&viewport, 0, 0, use_view ? view->width : target->width,
+	                        use_view ? view->height : target->height, 0, 1);
+	_rb_gl2_viewport(backend_gl2, target, nullptr, &viewport);
+
 	for (size_t context_index = 0, context_size = num_contexts; context_index < context_size;
 	     ++context_index) {
 		render_context_t* context = contexts[context_index];
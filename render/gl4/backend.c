@@ -44,6 +44,21 @@ nvoglexpert_callback(unsigned int category, unsigned int id, unsigned int detail
 
 #include <render/gl4/glprocs.h>
 
+#if !defined(GL_GLEXT_PROTOTYPES) || defined(GL_VERSION_4_4)
+#define RENDER_GL4_VERTEX_BINDING 1
+#else
+#define RENDER_GL4_VERTEX_BINDING 0
+#endif
+
+//! Vertex array shared by all draws with the same vertex declaration
+typedef struct render_vertex_array_gl4_t {
+	GLuint object;
+	//! Mask of currently enabled attributes
+	uint32_t enabled;
+	GLuint buffer_object[RENDER_MAX_VERTEX_BINDINGS];
+	GLsizei stride[RENDER_MAX_VERTEX_BINDINGS];
+} render_vertex_array_gl4_t;
+
 typedef struct render_backend_gl4_t {
 	RENDER_DECLARE_BACKEND;
 
@@ -57,6 +72,21 @@ typedef struct render_backend_gl4_t {
 	render_resolution_t resolution;
 
 	bool use_clear_scissor;
+	bool use_vertex_binding;
+
+	render_vertex_array_gl4_t* vertex_array;
+	size_t vertex_array_count;
+	GLuint bound_vertex_array;
+
+	GLuint staging_buffer;
+	size_t staging_size;
+
+	GLsync frame_fence[RENDER_FRAMES_IN_FLIGHT_MAX];
+
+	//! Timestamp query pairs of GPU timers, timer N uses queries 2(N-1) and 2(N-1)+1
+	GLuint* timer_query;
+	//! Released GPU timers
+	unsigned int* timer_free;
 } render_backend_gl4_t;
 
 const char*
@@ -756,6 +786,31 @@ _rb_gl4_destruct(render_backend_t* backend) {
 	memory_deallocate(backend_gl4->concurrent_context);
 	memory_deallocate(backend_gl4->concurrent_buffer);
 
+	if (backend_gl4->staging_buffer) {
+		GLuint staging_buffer = backend_gl4->staging_buffer;
+		glDeleteBuffers(1, &staging_buffer);
+		backend_gl4->staging_buffer = 0;
+	}
+
+	if (array_size(backend_gl4->timer_query))
+		glDeleteQueries((GLsizei)array_size(backend_gl4->timer_query), backend_gl4->timer_query);
+	array_deallocate(backend_gl4->timer_query);
+	array_deallocate(backend_gl4->timer_free);
+
+	for (size_t ifence = 0; ifence < RENDER_FRAMES_IN_FLIGHT_MAX; ++ifence) {
+		if (backend_gl4->frame_fence[ifence])
+			glDeleteSync(backend_gl4->frame_fence[ifence]);
+		backend_gl4->frame_fence[ifence] = 0;
+	}
+
+	for (size_t iarray = 0; iarray < backend_gl4->vertex_array_count; ++iarray) {
+		if (backend_gl4->vertex_array[iarray].object)
+			glDeleteVertexArrays(1, &backend_gl4->vertex_array[iarray].object);
+	}
+	memory_deallocate(backend_gl4->vertex_array);
+	backend_gl4->vertex_array = nullptr;
+	backend_gl4->vertex_array_count = 0;
+
 	_rb_gl4_disable_thread(backend);
 	if (backend_gl4->context)
 		_rb_gl_destroy_context(&backend_gl4->drawable, backend_gl4->context);
@@ -851,6 +906,16 @@ _rb_gl4_set_drawable(render_backend_t* backend, const render_drawable_t* drawabl
 	if (!_rb_gl_get_standard_procs(4, 0))
 		return false;
 
+	backend_gl4->use_vertex_binding = _rb_gl_get_vertex_binding_procs();
+	log_debugf(HASH_RENDER, STRING_CONST("Vertex attribute binding: %s"),
+	           backend_gl4->use_vertex_binding ? "supported" : "not supported");
+	if (backend_gl4->use_vertex_binding) {
+		backend_gl4->vertex_array_count = _render_config.vertex_decl_max + 1;
+		backend_gl4->vertex_array = memory_allocate(
+		    HASH_RENDER, sizeof(render_vertex_array_gl4_t) * backend_gl4->vertex_array_count, 0,
+		    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	}
+
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
@@ -974,22 +1039,42 @@ exit:
 static void*
 _rb_gl4_allocate_buffer(render_backend_t* backend, render_buffer_t* buffer) {
 	FOUNDATION_UNUSED(backend);
+	render_backend_memory_track_buffer(buffer, (int64_t)buffer->buffersize, 0);
 	return memory_allocate(HASH_RENDER, buffer->buffersize, 16, MEMORY_PERSISTENT);
 }
 
 static void
 _rb_gl4_deallocate_buffer(render_backend_t* backend, render_buffer_t* buffer, bool sys, bool aux) {
-	FOUNDATION_UNUSED(backend);
-	if (sys)
+	render_backend_gl4_t* backend_gl4 = (render_backend_gl4_t*)backend;
+	// State buffer store is embedded in the buffer
+	if (sys && buffer->store && (buffer->buffertype != RENDERBUFFER_STATE)) {
 		memory_deallocate(buffer->store);
+		render_backend_memory_track_buffer(buffer, -(int64_t)buffer->buffersize, 0);
+	}
 
 	if (aux) {
 		if (buffer->backend_data[0]) {
 			GLuint buffer_object = (GLuint)buffer->backend_data[0];
+			// Shared vertex arrays keep the deleted buffer attached until rebound, and the
+			// name may be reused, so force a rebind of any cached binding
+			if (buffer->buffertype == RENDERBUFFER_VERTEX) {
+				for (size_t iarray = 0; iarray < backend_gl4->vertex_array_count; ++iarray) {
+					render_vertex_array_gl4_t* array = backend_gl4->vertex_array + iarray;
+					for (unsigned int binding = 0; binding < RENDER_MAX_VERTEX_BINDINGS; ++binding) {
+						if (array->buffer_object[binding] == buffer_object)
+							array->buffer_object[binding] = 0xFFFFFFFF;
+					}
+				}
+			}
 			glDeleteBuffers(1, &buffer_object);
 			buffer->backend_data[0] = 0;
+			render_backend_memory_track_buffer(buffer, 0, -(int64_t)buffer->buffersize);
 		}
-		if (buffer->backend_data[1]) {
+		if (buffer->backend_data[1] && (buffer->buffertype == RENDERBUFFER_PALETTE)) {
+			GLuint texture = (GLuint)buffer->backend_data[1];
+			glDeleteTextures(1, &texture);
+			buffer->backend_data[1] = 0;
+		} else if (buffer->backend_data[1]) {
 			GLuint vertex_array = (GLuint)buffer->backend_data[1];
 			glDeleteVertexArrays(1, &vertex_array);
 			buffer->backend_data[1] = 0;
@@ -997,29 +1082,98 @@ _rb_gl4_deallocate_buffer(render_backend_t* backend, render_buffer_t* buffer, bo
 	}
 }
 
-static const GLint _rb_gl4_vertex_format_size[VERTEXFORMAT_NUMTYPES] = {1, 2, 3, 4, 4, 4,
-                                                                        1, 2, 4, 1, 2, 4};
+static const GLint _rb_gl4_vertex_format_size[VERTEXFORMAT_NUMTYPES] = {
+    1, 2, 3, 4, 4, 4, 1, 2, 4, 1, 2, 4, 2, 4, 2, 4, 2, 4, 4};
 static const GLenum _rb_gl4_vertex_format_type[VERTEXFORMAT_NUMTYPES] = {
-    GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_UNSIGNED_BYTE, GL_BYTE,
-    GL_SHORT, GL_SHORT, GL_SHORT, GL_INT,   GL_INT,           GL_INT};
+    GL_FLOAT,          GL_FLOAT,         GL_FLOAT,          GL_FLOAT,
+    GL_UNSIGNED_BYTE,  GL_BYTE,          GL_SHORT,          GL_SHORT,
+    GL_SHORT,          GL_INT,           GL_INT,            GL_INT,
+    GL_HALF_FLOAT,     GL_HALF_FLOAT,    GL_SHORT,          GL_SHORT,
+    GL_UNSIGNED_SHORT, GL_UNSIGNED_SHORT, GL_INT_2_10_10_10_REV};
 static const GLboolean _rb_gl4_vertex_format_norm[VERTEXFORMAT_NUMTYPES] = {
-    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE,  GL_TRUE,
-    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE};
+    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE, GL_TRUE, GL_FALSE,
+    GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE,
+    GL_TRUE,  GL_TRUE,  GL_TRUE,  GL_TRUE,  GL_TRUE};
 
 static bool
-_rb_gl4_upload_buffer(render_backend_t* backend, render_buffer_t* buffer) {
-	FOUNDATION_UNUSED(backend);
-	if ((buffer->buffertype == RENDERBUFFER_PARAMETER) ||
-	    (buffer->buffertype == RENDERBUFFER_STATE))
-		return true;
+_rb_gl4_setup_vertex_array(render_backend_gl4_t* backend, render_buffer_t* buffer,
+                           GLuint buffer_object) {
+	// Without attribute binding support the vertex array captures the buffer object,
+	// so each buffer needs its own vertex array
+	GLuint vertex_array = (GLuint)buffer->backend_data[1];
+	if (!vertex_array) {
+		glGenVertexArrays(1, &vertex_array);
+		if (_rb_gl_check_error("Unable to create vertex array"))
+			return false;
+		buffer->backend_data[1] = vertex_array;
+	}
+	glBindVertexArray(vertex_array);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer_object);
+
+	// Attributes in binding slot 0 are sourced from this buffer, other slots are
+	// bound and enabled at draw time if the render command has buffers for them
+	render_vertexbuffer_t* vertexbuffer = (render_vertexbuffer_t*)buffer;
+	const render_vertex_decl_t* decl = &vertexbuffer->decl;
+	uint32_t enabled = 0;
+	for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
+		const uint8_t format = decl->attribute[attrib].format;
+		if ((format < VERTEXFORMAT_NUMTYPES) && !decl->attribute[attrib].binding) {
+			glVertexAttribPointer(
+			    attrib, _rb_gl4_vertex_format_size[format], _rb_gl4_vertex_format_type[format],
+			    _rb_gl4_vertex_format_norm[format], (GLsizei)decl->attribute[attrib].stride,
+			    (const void*)(uintptr_t)decl->attribute[attrib].offset);
+			_rb_gl_check_error("Error creating vertex array (bind attribute)");
+			glEnableVertexAttribArray(attrib);
+			_rb_gl_check_error("Error creating vertex array (enable attribute)");
+			enabled |= (1U << attrib);
+		} else {
+			glDisableVertexAttribArray(attrib);
+		}
+	}
+	buffer->backend_data[2] = enabled;
+	backend->bound_vertex_array = 0;
+	return !_rb_gl_check_error("Error creating vertex array (bind attributes)");
+}
 
+static GLuint
+_rb_gl4_buffer_object(render_buffer_t* buffer) {
 	GLuint buffer_object = (GLuint)buffer->backend_data[0];
 	if (!buffer_object) {
 		glGenBuffers(1, &buffer_object);
 		if (_rb_gl_check_error("Unable to create buffer object"))
-			return false;
+			return 0;
 		buffer->backend_data[0] = buffer_object;
+		render_backend_memory_track_buffer(buffer, 0, (int64_t)buffer->buffersize);
 	}
+	return buffer_object;
+}
+
+static bool
+_rb_gl4_setup_palette_texture(render_buffer_t* buffer, GLuint buffer_object) {
+	// Texture buffer refers to the buffer object and remains valid when the data
+	// store is respecified, so it only needs to be attached once
+	if (buffer->backend_data[1])
+		return true;
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	if (_rb_gl_check_error("Unable to create palette texture"))
+		return false;
+	glBindTexture(GL_TEXTURE_BUFFER, texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer_object);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	buffer->backend_data[1] = texture;
+	return !_rb_gl_check_error("Unable to attach palette texture buffer");
+}
+
+static bool
+_rb_gl4_upload_buffer(render_backend_t* backend, render_buffer_t* buffer) {
+	if ((buffer->buffertype == RENDERBUFFER_PARAMETER) ||
+	    (buffer->buffertype == RENDERBUFFER_STATE))
+		return true;
+
+	GLuint buffer_object = _rb_gl4_buffer_object(buffer);
+	if (!buffer_object)
+		return false;
 
 	glBindBuffer(GL_ARRAY_BUFFER, buffer_object);
 	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)buffer->buffersize, buffer->store,
@@ -1027,38 +1181,125 @@ _rb_gl4_upload_buffer(render_backend_t* backend, render_buffer_t* buffer) {
 	if (_rb_gl_check_error("Unable to upload buffer object data"))
 		return false;
 
-	if (buffer->buffertype == RENDERBUFFER_VERTEX) {
-		GLuint vertex_array = (GLuint)buffer->backend_data[1];
-		if (!vertex_array) {
-			glGenVertexArrays(1, &vertex_array);
-			if (_rb_gl_check_error("Unable to create vertex array"))
-				return false;
-			buffer->backend_data[1] = vertex_array;
+	render_backend_gl4_t* backend_gl4 = (render_backend_gl4_t*)backend;
+	if ((buffer->buffertype == RENDERBUFFER_VERTEX) && !backend_gl4->use_vertex_binding)
+		_rb_gl4_setup_vertex_array(backend_gl4, buffer, buffer_object);
+	else if ((buffer->buffertype == RENDERBUFFER_PALETTE) &&
+	         !_rb_gl4_setup_palette_texture(buffer, buffer_object))
+		return false;
+
+	buffer->flags &= ~(uint32_t)RENDERBUFFER_DIRTY;
+
+	return true;
+}
+
+#define RENDER_GL4_STAGING_ALIGN 256
+#define RENDER_GL4_STAGED_BUFFERS \
+	(RENDERBUFFER_VERTEX | RENDERBUFFER_INDEX | RENDERBUFFER_PALETTE)
+
+static bool
+_rb_gl4_upload_buffers(render_backend_t* backend, render_buffer_t** buffers, size_t num_buffers) {
+	render_backend_gl4_t* backend_gl4 = (render_backend_gl4_t*)backend;
+
+	size_t staging_size = 0;
+	size_t num_staged = 0;
+	for (size_t ibuf = 0; ibuf < num_buffers; ++ibuf) {
+		render_buffer_t* buffer = buffers[ibuf];
+		if ((buffer->buffertype & RENDER_GL4_STAGED_BUFFERS) && buffer->store &&
+		    buffer->buffersize) {
+			staging_size += (buffer->buffersize + (RENDER_GL4_STAGING_ALIGN - 1)) &
+			                ~(size_t)(RENDER_GL4_STAGING_ALIGN - 1);
+			++num_staged;
 		}
-		glBindVertexArray(vertex_array);
+	}
 
-		render_vertexbuffer_t* vertexbuffer = (render_vertexbuffer_t*)buffer;
-		const render_vertex_decl_t* decl = &vertexbuffer->decl;
-		for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
-			const uint8_t format = decl->attribute[attrib].format;
-			if (format < VERTEXFORMAT_NUMTYPES) {
-				glVertexAttribPointer(
-				    attrib, _rb_gl4_vertex_format_size[format], _rb_gl4_vertex_format_type[format],
-				    _rb_gl4_vertex_format_norm[format], (GLsizei)decl->attribute[attrib].stride,
-				    (const void*)(uintptr_t)decl->attribute[attrib].offset);
-				_rb_gl_check_error("Error creating vertex array (bind attribute)");
-				glEnableVertexAttribArray(attrib);
-				_rb_gl_check_error("Error creating vertex array (enable attribute)");
-			} else {
-				glDisableVertexAttribArray(attrib);
-			}
+	// Nothing to coalesce, respecify single buffer directly from system memory
+	bool success = true;
+	if (num_staged < 2) {
+		for (size_t ibuf = 0; ibuf < num_buffers; ++ibuf)
+			success &= _rb_gl4_upload_buffer(backend, buffers[ibuf]);
+		return success;
+	}
+
+	// Copy all buffer data into one orphaned staging buffer with a single mapping, then
+	// respecify each destination with an orphaned store and copy on the GPU. No draw has
+	// been issued yet this frame, so no buffer in use by the GPU is overwritten in place
+	if (!backend_gl4->staging_buffer) {
+		GLuint staging_buffer = 0;
+		glGenBuffers(1, &staging_buffer);
+		if (_rb_gl_check_error("Unable to create staging buffer"))
+			return false;
+		backend_gl4->staging_buffer = staging_buffer;
+	}
+	if (staging_size > backend_gl4->staging_size)
+		backend_gl4->staging_size = staging_size + (staging_size / 2);
+
+	glBindBuffer(GL_COPY_READ_BUFFER, backend_gl4->staging_buffer);
+	glBufferData(GL_COPY_READ_BUFFER, (GLsizeiptr)backend_gl4->staging_size, nullptr,
+	             GL_STREAM_DRAW);
+	void* staging = glMapBufferRange(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)staging_size,
+	                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (!staging) {
+		_rb_gl_check_error("Unable to map staging buffer");
+		for (size_t ibuf = 0; ibuf < num_buffers; ++ibuf)
+			success &= _rb_gl4_upload_buffer(backend, buffers[ibuf]);
+		return success;
+	}
+
+	size_t offset = 0;
+	for (size_t ibuf = 0; ibuf < num_buffers; ++ibuf) {
+		render_buffer_t* buffer = buffers[ibuf];
+		if ((buffer->buffertype & RENDER_GL4_STAGED_BUFFERS) && buffer->store &&
+		    buffer->buffersize) {
+			memcpy(pointer_offset(staging, offset), buffer->store, buffer->buffersize);
+			offset += (buffer->buffersize + (RENDER_GL4_STAGING_ALIGN - 1)) &
+			          ~(size_t)(RENDER_GL4_STAGING_ALIGN - 1);
 		}
-		_rb_gl_check_error("Error creating vertex array (bind attributes)");
 	}
+	glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+	// Buffers are visited in the same order as when staging to match offsets
+	offset = 0;
+	for (size_t ibuf = 0; ibuf < num_buffers; ++ibuf) {
+		render_buffer_t* buffer = buffers[ibuf];
+		if (!(buffer->buffertype & RENDER_GL4_STAGED_BUFFERS) || !buffer->store ||
+		    !buffer->buffersize) {
+			success &= _rb_gl4_upload_buffer(backend, buffer);
+			continue;
+		}
 
-	buffer->flags &= ~(uint32_t)RENDERBUFFER_DIRTY;
+		size_t staged_offset = offset;
+		offset += (buffer->buffersize + (RENDER_GL4_STAGING_ALIGN - 1)) &
+		          ~(size_t)(RENDER_GL4_STAGING_ALIGN - 1);
 
-	return true;
+		GLuint buffer_object = _rb_gl4_buffer_object(buffer);
+		if (!buffer_object) {
+			success = false;
+			continue;
+		}
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_object);
+		glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)buffer->buffersize, nullptr,
+		             (buffer->usage == RENDERUSAGE_DYNAMIC) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+		                    (GLintptr)staged_offset, 0, (GLsizeiptr)buffer->buffersize);
+		if (_rb_gl_check_error("Unable to copy staged buffer object data")) {
+			success = false;
+			continue;
+		}
+
+		if ((buffer->buffertype == RENDERBUFFER_VERTEX) && !backend_gl4->use_vertex_binding)
+			_rb_gl4_setup_vertex_array(backend_gl4, buffer, buffer_object);
+		else if ((buffer->buffertype == RENDERBUFFER_PALETTE) &&
+		         !_rb_gl4_setup_palette_texture(buffer, buffer_object)) {
+			success = false;
+			continue;
+		}
+
+		buffer->flags &= ~(uint32_t)RENDERBUFFER_DIRTY;
+	}
+
+	return success;
 }
 
 static void
@@ -1199,6 +1440,7 @@ _rb_gl4_upload_program(render_backend_t* backend, render_program_t* program) {
 	if (!_rb_gl4_check_program_link(handle))
 		return false;
 
+	program->backend_data[3] = 0;
 	glGetProgramiv(handle, GL_ACTIVE_UNIFORMS, &uniforms);
 	for (iu = 0; iu < uniforms; ++iu) {
 		num_chars = 0;
@@ -1206,6 +1448,12 @@ _rb_gl4_upload_program(render_backend_t* backend, render_program_t* program) {
 		type = GL_NONE;
 		glGetActiveUniform(handle, (GLuint)iu, sizeof(name), &num_chars, &size, &type, name);
 
+		// Palette offset is set from the render command and not part of parameter buffers
+		if (string_equal(name, (size_t)num_chars, STRING_CONST("palette_offset"))) {
+			program->backend_data[3] = (uintptr_t)(glGetUniformLocation(handle, name) + 1);
+			continue;
+		}
+
 		name_hash = hash(name, (size_t)num_chars);
 		for (size_t iparam = 0; iparam < program->num_parameters; ++iparam) {
 			render_parameter_t* parameter = program->parameters + iparam;
@@ -1215,6 +1463,9 @@ _rb_gl4_upload_program(render_backend_t* backend, render_program_t* program) {
 	}
 
 	program->backend_data[0] = handle;
+	// Uniform values of a newly linked program are reset
+	program->backend_data[1] = 0;
+	program->backend_data[2] = 0;
 
 	return true;
 }
@@ -1227,9 +1478,14 @@ _rb_gl4_deallocate_program(render_backend_t* backend, render_program_t* program)
 	program->backend_data[0] = 0;
 }
 
+//! Estimated size of target storage, drivers pad RGB8 color and 24-bit depth to 32 bits
+static uint64_t
+_rb_gl_target_memory_size(unsigned int width, unsigned int height) {
+	return (uint64_t)width * (uint64_t)height * 8;
+}
+
 bool
 _rb_gl_allocate_target(render_backend_t* backend, render_target_t* target) {
-	FOUNDATION_UNUSED(backend);
 	if (!target->width || !target->height)
 		return false;
 
@@ -1318,6 +1574,9 @@ _rb_gl_allocate_target(render_backend_t* backend, render_target_t* target) {
 	target->backend_data[0] = frame_buffer;
 	target->backend_data[1] = depth_buffer;
 	target->backend_data[2] = render_texture;
+	target->backend_data[3] = (uintptr_t)_rb_gl_target_memory_size(target->width, target->height);
+	render_backend_memory_track(backend, RENDERRESOURCE_TARGET, RENDERUSAGE_TARGET, 0,
+	                            (int64_t)target->backend_data[3]);
 
 	return true;
 
@@ -1405,12 +1664,19 @@ _rb_gl_resize_target(render_backend_t* backend, render_target_t* target, unsigne
 	}
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	uint64_t target_size = _rb_gl_target_memory_size(width, height);
+	render_backend_memory_track(backend, RENDERRESOURCE_TARGET, RENDERUSAGE_TARGET, 0,
+	                            (int64_t)target_size - (int64_t)target->backend_data[3]);
+	target->backend_data[3] = (uintptr_t)target_size;
+
 	return true;
 }
 
 void
 _rb_gl_deallocate_target(render_backend_t* backend, render_target_t* target) {
-	FOUNDATION_UNUSED(backend);
+	render_backend_memory_track(backend, RENDERRESOURCE_TARGET, RENDERUSAGE_TARGET, 0,
+	                            -(int64_t)target->backend_data[3]);
 	if (target->backend_data[2])
 		glDeleteTextures(1, (const GLuint*)&target->backend_data[2]);
 	if (target->backend_data[1])
@@ -1427,10 +1693,53 @@ _rb_gl_activate_target(render_backend_t* backend, render_target_t* target) {
 	return true;
 }
 
+void
+_rb_gl_blit_target(render_backend_t* backend, render_target_t* target, render_command_t* command) {
+	const render_command_blit_t* blit = &command->data.blit;
+	render_target_t* source = blit->source;
+	if (!source)
+		return;
+
+	GLint src_x = blit->source_x;
+	GLint src_y = blit->source_y;
+	GLint src_w = blit->source_width ? blit->source_width : (GLint)source->width;
+	GLint src_h = blit->source_height ? blit->source_height : (GLint)source->height;
+	GLint dst_x = blit->x;
+	GLint dst_y = blit->y;
+	GLint dst_w = blit->width ? blit->width : (GLint)target->width;
+	GLint dst_h = blit->height ? blit->height : (GLint)target->height;
+	const render_view_t* view = backend->view;
+	if (view && view->width && view->height) {
+		dst_x += (GLint)view->x;
+		dst_y += (GLint)view->y;
+	}
+
+	GLbitfield bits = 0;
+	if (blit->buffer_mask & RENDERBUFFER_COLOR)
+		bits |= GL_COLOR_BUFFER_BIT;
+	if (blit->buffer_mask & RENDERBUFFER_DEPTH)
+		bits |= GL_DEPTH_BUFFER_BIT;
+	if (blit->buffer_mask & RENDERBUFFER_STENCIL)
+		bits |= GL_STENCIL_BUFFER_BIT;
+
+	// Depth and stencil can only be copied with nearest filtering
+	bool scaled = (src_w != dst_w) || (src_h != dst_h);
+	GLenum filter = (scaled && (bits == GL_COLOR_BUFFER_BIT)) ? GL_LINEAR : GL_NEAREST;
+
+	// Blits bypass the fragment pipeline, only the scissor test applies and is disabled
+	// outside of clears. Multisampled sources are resolved by the blit
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)source->backend_data[0]);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)target->backend_data[0]);
+	glBlitFramebuffer(src_x, src_y, src_x + src_w, src_y + src_h, dst_x, dst_y, dst_x + dst_w,
+	                  dst_y + dst_h, bits, filter);
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)target->backend_data[0]);
+
+	_rb_gl_check_error("Error blitting target");
+}
+
 bool
 _rb_gl_upload_texture(render_backend_t* backend, render_texture_t* texture, const void* buffer,
                       size_t size) {
-	FOUNDATION_UNUSED(backend);
 	FOUNDATION_UNUSED(size);
 
 	_rb_gl_check_error("Error prior to texture upload");
@@ -1539,6 +1848,7 @@ _rb_gl_upload_texture(render_backend_t* backend, render_texture_t* texture, cons
 	const void* data = buffer;
 	unsigned int level_width = texture->width;
 	unsigned int level_height = texture->height;
+	uint64_t texture_size = 0;
 	for (GLint ilevel = 0; ilevel < (GLint)texture->levels; ++ilevel) {
 		unsigned int data_length = level_width * level_height * (bits_per_pixel / 8);
 		if (data_length > size) {
@@ -1554,6 +1864,7 @@ _rb_gl_upload_texture(render_backend_t* backend, render_texture_t* texture, cons
 
 		data = pointer_offset_const(data, data_length);
 		size -= data_length;
+		texture_size += data_length;
 		level_width = math_max(level_width >> 1, 1);
 		level_height = math_max(level_height >> 1, 1);
 	}
@@ -1564,6 +1875,14 @@ _rb_gl_upload_texture(render_backend_t* backend, render_texture_t* texture, cons
 	if (_rb_gl_check_error("Unable to upload texture data"))
 		return false;
 
+	// Generated mipmap chain adds a third of the base level size
+	if (generate_mipmaps && (texture->levels <= 1))
+		texture_size += texture_size / 3;
+	// Byte count is kept with the texture object, replacing any previous upload
+	render_backend_memory_track(backend, RENDERRESOURCE_TEXTURE, texture->usage, 0,
+	                            (int64_t)texture_size - (int64_t)texture->backend_data[1]);
+	texture->backend_data[1] = (uintptr_t)texture_size;
+
 	return true;
 }
 
@@ -1581,10 +1900,12 @@ _rb_gl_parameter_bind_target(render_backend_t* backend, void* buffer, render_tar
 
 void
 _rb_gl_deallocate_texture(render_backend_t* backend, render_texture_t* texture) {
-	FOUNDATION_UNUSED(backend);
 	if (texture->backend_data[0])
 		glDeleteTextures(1, (GLuint*)&texture->backend_data[0]);
 	texture->backend_data[0] = 0;
+	render_backend_memory_track(backend, RENDERRESOURCE_TEXTURE, texture->usage, 0,
+	                            -(int64_t)texture->backend_data[1]);
+	texture->backend_data[1] = 0;
 }
 
 static void
@@ -1639,6 +1960,10 @@ _rb_gl4_viewport(render_backend_gl4_t* backend, render_target_t* target, render_
 	GLint y = (GLint)command->data.viewport.y;
 	GLsizei w = (GLsizei)command->data.viewport.width;
 	GLsizei h = (GLsizei)command->data.viewport.height;
+	if (backend->view && backend->view->width && backend->view->height) {
+		x += (GLint)backend->view->x;
+		y += (GLint)backend->view->y;
+	}
 
 	glViewport(x, y, w, h);
 	glScissor(x, y, w, h);
@@ -1677,6 +2002,7 @@ static void
 _rb_gl4_set_default_state(void) {
 	glBlendFunc(GL_ONE, GL_ZERO);
 	glDisable(GL_BLEND);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 	glDepthFunc(GL_LEQUAL);
 	glDepthMask(GL_TRUE);
 	glEnable(GL_DEPTH_TEST);
@@ -1688,10 +2014,12 @@ static void
 _rb_gl4_set_state(render_state_t* state) {
 	glBlendFunc(_rb_gl4_blend_func[state->blend_source_color],
 	            _rb_gl4_blend_func[state->blend_dest_color]);
-	if (state->blend_enable)
+	if (state->blend_enable[0])
 		glEnable(GL_BLEND);
 	else
 		glDisable(GL_BLEND);
+	GLboolean color_write = state->target_write[0] ? GL_TRUE : GL_FALSE;
+	glColorMask(color_write, color_write, color_write, color_write);
 	glDepthFunc(_rb_gl4_cmp_func[state->depth_func]);
 	glDepthMask(state->depth_write ? GL_TRUE : GL_FALSE);
 	glEnable(GL_DEPTH_TEST);
@@ -1699,12 +2027,151 @@ _rb_gl4_set_state(render_state_t* state) {
 	glEnable(GL_CULL_FACE);
 }
 
+static uint32_t
+_rb_gl4_vertex_enable_mask(const render_vertex_decl_t* decl, const GLuint* buffer_object) {
+	uint32_t enabled = 0;
+	for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
+		const unsigned int binding = decl->attribute[attrib].binding;
+		if ((decl->attribute[attrib].format < VERTEXFORMAT_NUMTYPES) &&
+		    (binding < RENDER_MAX_VERTEX_BINDINGS) && buffer_object[binding])
+			enabled |= (1U << attrib);
+	}
+	return enabled;
+}
+
+static void
+_rb_gl4_vertex_enable(uint32_t enabled, uint32_t current) {
+	uint32_t changed = enabled ^ current;
+	for (unsigned int attrib = 0; changed; ++attrib, changed >>= 1) {
+		if (!(changed & 1))
+			continue;
+		if (enabled & (1U << attrib))
+			glEnableVertexAttribArray(attrib);
+		else
+			glDisableVertexAttribArray(attrib);
+	}
+}
+
+#if RENDER_GL4_VERTEX_BINDING
+
+static void
+_rb_gl4_vertex_array_format(render_vertex_array_gl4_t* array, const render_vertex_decl_t* decl) {
+	for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
+		const uint8_t format = decl->attribute[attrib].format;
+		if (format < VERTEXFORMAT_NUMTYPES) {
+			glVertexAttribFormat(attrib, _rb_gl4_vertex_format_size[format],
+			                     _rb_gl4_vertex_format_type[format],
+			                     _rb_gl4_vertex_format_norm[format], decl->attribute[attrib].offset);
+			glVertexAttribBinding(attrib, decl->attribute[attrib].binding);
+		}
+	}
+	for (unsigned int binding = 0; binding < RENDER_MAX_VERTEX_BINDINGS; ++binding)
+		array->stride[binding] = (GLsizei)render_vertex_decl_binding_stride(decl, binding);
+	_rb_gl_check_error("Error creating vertex array (attribute format)");
+}
+
+static void
+_rb_gl4_bind_shared_vertex_array(render_backend_gl4_t* backend, const render_vertex_decl_t* decl,
+                                 unsigned int decl_id, const GLuint* buffer_object) {
+	// Vertex arrays hold only the attribute layout and are shared by all buffers with the
+	// same interned declaration. Slot 0 is used for declarations that could not be interned
+	// and is reformatted on every use
+	render_vertex_array_gl4_t* array = backend->vertex_array + decl_id;
+	bool bind_buffers = false;
+	if (!array->object) {
+		glGenVertexArrays(1, &array->object);
+		if (_rb_gl_check_error("Unable to create vertex array"))
+			return;
+		glBindVertexArray(array->object);
+		_rb_gl4_vertex_array_format(array, decl);
+		backend->bound_vertex_array = array->object;
+		bind_buffers = true;
+	} else if (backend->bound_vertex_array != array->object) {
+		glBindVertexArray(array->object);
+		backend->bound_vertex_array = array->object;
+		bind_buffers = true;
+	}
+	if (!decl_id) {
+		_rb_gl4_vertex_array_format(array, decl);
+		bind_buffers = true;
+	}
+
+	if (bind_buffers ||
+	    memcmp(array->buffer_object, buffer_object, sizeof(array->buffer_object))) {
+		GLintptr offset[RENDER_MAX_VERTEX_BINDINGS] = {0};
+		glBindVertexBuffers(0, RENDER_MAX_VERTEX_BINDINGS, buffer_object, offset, array->stride);
+		memcpy(array->buffer_object, buffer_object, sizeof(array->buffer_object));
+	}
+
+	uint32_t enabled = _rb_gl4_vertex_enable_mask(decl, buffer_object);
+	_rb_gl4_vertex_enable(enabled, array->enabled);
+	array->enabled = enabled;
+}
+
+#endif
+
+static void
+_rb_gl4_bind_vertex_streams(render_backend_gl4_t* backend, render_vertexbuffer_t* vertexbuffer,
+                            render_vertexbuffer_t** stream) {
+	const render_vertex_decl_t* decl = &vertexbuffer->decl;
+	GLuint buffer_object[RENDER_MAX_VERTEX_BINDINGS];
+	unsigned int num_streams = 1;
+
+	buffer_object[0] = (GLuint)vertexbuffer->backend_data[0];
+	for (unsigned int istream = 1; istream < RENDER_MAX_VERTEX_BINDINGS; ++istream) {
+		render_vertexbuffer_t* streambuffer = stream[istream - 1];
+		buffer_object[istream] = 0;
+		if (streambuffer) {
+			if (streambuffer->flags & RENDERBUFFER_DIRTY)
+				render_buffer_upload((render_buffer_t*)streambuffer);
+			buffer_object[istream] = (GLuint)streambuffer->backend_data[0];
+			num_streams = istream + 1;
+		}
+	}
+
+#if RENDER_GL4_VERTEX_BINDING
+	if (backend->use_vertex_binding) {
+		unsigned int decl_id = vertexbuffer->decl_id;
+		if (decl_id >= backend->vertex_array_count)
+			decl_id = 0;
+		_rb_gl4_bind_shared_vertex_array(backend, decl, decl_id, buffer_object);
+		return;
+	}
+#endif
+
+	GLuint vertex_array = (GLuint)vertexbuffer->backend_data[1];
+	glBindVertexArray(vertex_array);
+	backend->bound_vertex_array = vertex_array;
+
+	if (num_streams > 1) {
+		for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
+			const unsigned int binding = decl->attribute[attrib].binding;
+			if (!binding || (binding >= RENDER_MAX_VERTEX_BINDINGS) || !buffer_object[binding])
+				continue;
+			const uint8_t format = decl->attribute[attrib].format;
+			if (format >= VERTEXFORMAT_NUMTYPES)
+				continue;
+			glBindBuffer(GL_ARRAY_BUFFER, buffer_object[binding]);
+			glVertexAttribPointer(
+			    attrib, _rb_gl4_vertex_format_size[format], _rb_gl4_vertex_format_type[format],
+			    _rb_gl4_vertex_format_norm[format], (GLsizei)decl->attribute[attrib].stride,
+			    (const void*)(uintptr_t)decl->attribute[attrib].offset);
+		}
+	}
+
+	uint32_t enabled = _rb_gl4_vertex_enable_mask(decl, buffer_object);
+	_rb_gl4_vertex_enable(enabled, (uint32_t)vertexbuffer->backend_data[2]);
+	vertexbuffer->backend_data[2] = enabled;
+}
+
 static void
 _rb_gl4_render(render_backend_gl4_t* backend, render_context_t* context,
                render_command_t* command) {
 	render_vertexbuffer_t* vertexbuffer = command->data.render.vertexbuffer;
 	render_indexbuffer_t* indexbuffer = command->data.render.indexbuffer;
-	render_parameterbuffer_t* parameterbuffer = command->data.render.parameterbuffer;
+	render_parameterbuffer_t* parameterbuffer =
+	    render_backend_command_parameterbuffer((render_backend_t*)backend, command);
+	render_palettebuffer_t* palettebuffer = command->data.render.palettebuffer;
 	render_program_t* program = command->data.render.program;
 	FOUNDATION_UNUSED(context);
 
@@ -1714,14 +2181,15 @@ _rb_gl4_render(render_backend_gl4_t* backend, render_context_t* context,
 	}
 
 	if (vertexbuffer->flags & RENDERBUFFER_DIRTY)
-		_rb_gl4_upload_buffer((render_backend_t*)backend, (render_buffer_t*)vertexbuffer);
+		render_buffer_upload((render_buffer_t*)vertexbuffer);
 	if (indexbuffer->flags & RENDERBUFFER_DIRTY)
-		_rb_gl4_upload_buffer((render_backend_t*)backend, (render_buffer_t*)indexbuffer);
+		render_buffer_upload((render_buffer_t*)indexbuffer);
+	if (palettebuffer && (palettebuffer->flags & RENDERBUFFER_DIRTY))
+		render_buffer_upload((render_buffer_t*)palettebuffer);
 	_rb_gl_check_error("Error render primitives (upload buffers)");
 
 	// Bind vertex array
-	GLuint vertex_array = (GLuint)vertexbuffer->backend_data[1];
-	glBindVertexArray(vertex_array);
+	_rb_gl4_bind_vertex_streams(backend, vertexbuffer, command->data.render.vertexstream);
 	_rb_gl_check_error("Error render primitives (bind vertex array)");
 
 	// Index buffer
@@ -1732,7 +2200,19 @@ _rb_gl4_render(render_backend_gl4_t* backend, render_context_t* context,
 	glUseProgram((GLuint)program->backend_data[0]);
 	_rb_gl_check_error("Error render primitives (bind program)");
 
-	// Bind the parameter blocks
+	// Bind the parameter blocks. Uniform values are program state and are only uploaded
+	// if the program has not already received this generation of the parameter buffer,
+	// textures are context state and always bound
+	bool upload = (program->backend_data[1] != (uintptr_t)parameterbuffer) ||
+	              (program->backend_data[2] != parameterbuffer->generation);
+	if (upload) {
+		program->backend_data[1] = (uintptr_t)parameterbuffer;
+		program->backend_data[2] = parameterbuffer->generation;
+		++backend->statistics.parameter_uploads;
+	} else {
+		++backend->statistics.parameter_skips;
+	}
+
 	GLuint unit = 0;
 	render_parameter_t* param = parameterbuffer->parameters;
 	for (unsigned int ip = 0; ip < parameterbuffer->parameter_count; ++ip, ++param) {
@@ -1741,8 +2221,18 @@ _rb_gl4_render(render_backend_gl4_t* backend, render_context_t* context,
 			glActiveTexture(GL_TEXTURE0 + unit);
 			// glEnable(GL_TEXTURE_2D);
 			glBindTexture(GL_TEXTURE_2D, *(GLuint*)data);
-			glUniform1i((GLint)param->location, (GLint)unit);
+			if (upload)
+				glUniform1i((GLint)param->location, (GLint)unit);
+			++unit;
+		} else if (param->type == RENDERPARAMETER_PALETTE) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glBindTexture(GL_TEXTURE_BUFFER,
+			              palettebuffer ? (GLuint)palettebuffer->backend_data[1] : 0);
+			if (upload)
+				glUniform1i((GLint)param->location, (GLint)unit);
 			++unit;
+		} else if (!upload) {
+			continue;
 		} else if (param->type == RENDERPARAMETER_FLOAT4) {
 			glUniform4fv((GLint)param->location, param->dim, data);
 		} else if (param->type == RENDERPARAMETER_INT4) {
@@ -1750,8 +2240,14 @@ _rb_gl4_render(render_backend_gl4_t* backend, render_context_t* context,
 		} else if (param->type == RENDERPARAMETER_MATRIX) {
 			// Matrix math is row-major, must be transposed to match GL layout which is column major
 			glUniformMatrix4fv((GLint)param->location, param->dim, GL_TRUE, data);
+		} else if (param->type == RENDERPARAMETER_MATRIX_COLUMN) {
+			glUniformMatrix4fv((GLint)param->location, param->dim, GL_FALSE, data);
 		}
 	}
+	// Palette offset changes per draw and is the only value uploaded for every skinned draw
+	if (palettebuffer && program->backend_data[3])
+		glUniform1i((GLint)program->backend_data[3] - 1,
+		            (GLint)command->data.render.palette_offset);
 	_rb_gl_check_error("Error render primitives (bind uniforms)");
 
 	// TODO: Proper states
@@ -1794,6 +2290,10 @@ _rb_gl4_dispatch_command(render_backend_gl4_t* backend, render_target_t* target,
 			_rb_gl4_viewport(backend, target, context, command);
 			break;
 
+		case RENDERCOMMAND_BLIT:
+			_rb_gl_blit_target((render_backend_t*)backend, target, command);
+			break;
+
 		case RENDERCOMMAND_RENDER_TRIANGLELIST:
 		case RENDERCOMMAND_RENDER_LINELIST:
 			_rb_gl4_render(backend, context, command);
@@ -1809,6 +2309,17 @@ _rb_gl4_dispatch(render_backend_t* backend, render_target_t* target, render_cont
 	if (!_rb_gl_activate_target(backend, target))
 		return;
 
+	// A view without size covers the entire target, reset any viewport set by a previous view
+	const render_view_t* view = backend->view;
+	bool use_view = view && view->width && view->height;
+	render_command_t viewport;
+	render_command_viewport(&viewport, 0, 0, use_view ? view->width : target->width,
+	                        use_view ? view->height : target->height, 0, 1);
+	_rb_gl4_viewport(backend_gl4, target, nullptr, &viewport);
+
+	// Vertex array binding may have been changed outside of dispatch
+	backend_gl4->bound_vertex_array = 0;
+
 	for (size_t context_index = 0, context_size = num_contexts; context_index < context_size;
 	     ++context_index) {
 		render_context_t* context = contexts[context_index];
@@ -1825,6 +2336,75 @@ _rb_gl4_dispatch(render_backend_t* backend, render_target_t* target, render_cont
 	}
 }
 
+static unsigned int
+_rb_gl4_timer_begin(render_backend_t* backend) {
+	render_backend_gl4_t* backend_gl4 = (render_backend_gl4_t*)backend;
+	unsigned int timer;
+	size_t free_count = array_size(backend_gl4->timer_free);
+	if (free_count) {
+		timer = backend_gl4->timer_free[free_count - 1];
+		array_pop(backend_gl4->timer_free);
+	} else {
+		GLuint query[2] = {0, 0};
+		glGenQueries(2, query);
+		if (!query[0] || !query[1]) {
+			_rb_gl_check_error("Unable to create timer queries");
+			if (query[0] || query[1])
+				glDeleteQueries(2, query);
+			return 0;
+		}
+		array_push(backend_gl4->timer_query, query[0]);
+		array_push(backend_gl4->timer_query, query[1]);
+		timer = (unsigned int)(array_size(backend_gl4->timer_query) / 2);
+	}
+	glQueryCounter(backend_gl4->timer_query[(timer - 1) * 2], GL_TIMESTAMP);
+	return timer;
+}
+
+static void
+_rb_gl4_timer_end(render_backend_t* backend, unsigned int timer) {
+	render_backend_gl4_t* backend_gl4 = (render_backend_gl4_t*)backend;
+	glQueryCounter(backend_gl4->timer_query[((timer - 1) * 2) + 1], GL_TIMESTAMP);
+}
+
+static bool
+_rb_gl4_timer_result(render_backend_t* backend, unsigned int timer, uint64_t* nanoseconds) {
+	render_backend_gl4_t* backend_gl4 = (render_backend_gl4_t*)backend;
+	if (nanoseconds) {
+		// The end timestamp is available last, results are never waited for
+		GLint available = 0;
+		GLuint* query = backend_gl4->timer_query + ((timer - 1) * 2);
+		glGetQueryObjectiv(query[1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+		GLuint64 begin_time = 0;
+		GLuint64 end_time = 0;
+		glGetQueryObjectui64v(query[0], GL_QUERY_RESULT, &begin_time);
+		glGetQueryObjectui64v(query[1], GL_QUERY_RESULT, &end_time);
+		*nanoseconds = (end_time > begin_time) ? (uint64_t)(end_time - begin_time) : 0;
+	}
+	array_push(backend_gl4->timer_free, timer);
+	return (nanoseconds != nullptr);
+}
+
+/*! Fence the frame and block until the frame issued frames_in_flight flips ago is
+complete on the GPU, bounding how far the CPU can run ahead of presentation */
+static void
+_rb_gl4_frame_fence(render_backend_gl4_t* backend_gl4) {
+	size_t frames = _render_config.frames_in_flight;
+	size_t slot = (size_t)(backend_gl4->framecount % frames);
+	GLsync fence = backend_gl4->frame_fence[slot];
+	if (fence) {
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ULL);
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(fence, 0, 1000000000ULL);
+		if (result == GL_WAIT_FAILED)
+			_rb_gl_check_error("Unable to wait for frame fence");
+		glDeleteSync(fence);
+	}
+	backend_gl4->frame_fence[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
 static void
 _rb_gl4_flip(render_backend_t* backend) {
 	render_backend_gl4_t* backend_gl4 = (render_backend_gl4_t*)backend;
@@ -1859,6 +2439,8 @@ _rb_gl4_flip(render_backend_t* backend) {
 #error Not implemented
 #endif
 
+	_rb_gl4_frame_fence(backend_gl4);
+
 	++backend->framecount;
 }
 
@@ -1872,6 +2454,7 @@ static render_backend_vtable_t _render_backend_vtable_gl4 = {
     .disable_thread = _rb_gl4_disable_thread,
     .allocate_buffer = _rb_gl4_allocate_buffer,
     .upload_buffer = _rb_gl4_upload_buffer,
+    .upload_buffers = _rb_gl4_upload_buffers,
     .upload_shader = _rb_gl4_upload_shader,
     .upload_program = _rb_gl4_upload_program,
     .upload_texture = _rb_gl_upload_texture,
@@ -1885,6 +2468,9 @@ static render_backend_vtable_t _render_backend_vtable_gl4 = {
     .allocate_target = _rb_gl_allocate_target,
     .resize_target = _rb_gl_resize_target,
     .deallocate_target = _rb_gl_deallocate_target,
+    .timer_begin = _rb_gl4_timer_begin,
+    .timer_end = _rb_gl4_timer_end,
+    .timer_result = _rb_gl4_timer_result,
     .dispatch = _rb_gl4_dispatch,
     .flip = _rb_gl4_flip};
 
@@ -80,6 +80,18 @@ PFNGLUNMAPBUFFERPROC glUnmapBuffer;
 PFNGLGETBUFFERPARAMETERIVPROC glGetBufferParameteriv;
 PFNGLGETBUFFERPOINTERVPROC glGetBufferPointerv;
 
+PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData;
+
+PFNGLTEXBUFFERPROC glTexBuffer;
+
+PFNGLQUERYCOUNTERPROC glQueryCounter;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
+
+PFNGLFENCESYNCPROC glFenceSync;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+PFNGLDELETESYNCPROC glDeleteSync;
+
 PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate;
 PFNGLDRAWBUFFERSPROC glDrawBuffers;
 PFNGLSTENCILOPSEPARATEPROC glStencilOpSeparate;
@@ -138,11 +150,16 @@ PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers;
 PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage;
 PFNGLFRAMEBUFFERTEXTUREPROC glFramebufferTexture;
 PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer;
+PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
 
 PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
 PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
 
+PFNGLBINDVERTEXBUFFERSPROC glBindVertexBuffers;
+PFNGLVERTEXATTRIBFORMATPROC glVertexAttribFormat;
+PFNGLVERTEXATTRIBBINDINGPROC glVertexAttribBinding;
+
 PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
 PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl;
 #endif
@@ -227,6 +244,64 @@ _rb_gl_get_buffer_procs(void) {
 	return true;
 }
 
+bool
+_rb_gl_get_buffer_copy_procs(void) {
+#ifndef GL_GLEXT_PROTOTYPES
+	glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)_rb_gl_get_proc_address("glMapBufferRange");
+	glCopyBufferSubData =
+	    (PFNGLCOPYBUFFERSUBDATAPROC)_rb_gl_get_proc_address("glCopyBufferSubData");
+	if (!glMapBufferRange || !glCopyBufferSubData) {
+		log_error(HASH_RENDER, ERROR_UNSUPPORTED,
+		          STRING_CONST("Unable to get GL procs for buffer copies"));
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool
+_rb_gl_get_texture_buffer_procs(void) {
+#ifndef GL_GLEXT_PROTOTYPES
+	glTexBuffer = (PFNGLTEXBUFFERPROC)_rb_gl_get_proc_address("glTexBuffer");
+	if (!glTexBuffer) {
+		log_error(HASH_RENDER, ERROR_UNSUPPORTED,
+		          STRING_CONST("Unable to get GL procs for texture buffers"));
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool
+_rb_gl_get_timer_query_procs(void) {
+#ifndef GL_GLEXT_PROTOTYPES
+	glQueryCounter = (PFNGLQUERYCOUNTERPROC)_rb_gl_get_proc_address("glQueryCounter");
+	glGetQueryObjectui64v =
+	    (PFNGLGETQUERYOBJECTUI64VPROC)_rb_gl_get_proc_address("glGetQueryObjectui64v");
+	if (!glQueryCounter || !glGetQueryObjectui64v) {
+		log_error(HASH_RENDER, ERROR_UNSUPPORTED,
+		          STRING_CONST("Unable to get GL procs for timer queries"));
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool
+_rb_gl_get_sync_procs(void) {
+#ifndef GL_GLEXT_PROTOTYPES
+	glFenceSync = (PFNGLFENCESYNCPROC)_rb_gl_get_proc_address("glFenceSync");
+	glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)_rb_gl_get_proc_address("glClientWaitSync");
+	glDeleteSync = (PFNGLDELETESYNCPROC)_rb_gl_get_proc_address("glDeleteSync");
+	if (!glFenceSync || !glClientWaitSync || !glDeleteSync) {
+		log_error(HASH_RENDER, ERROR_UNSUPPORTED,
+		          STRING_CONST("Unable to get GL procs for sync objects"));
+		return false;
+	}
+#endif
+	return true;
+}
+
 bool
 _rb_gl_get_shader_procs(void) {
 #ifndef GL_GLEXT_PROTOTYPES
@@ -334,10 +409,11 @@ _rb_gl_get_framebuffer_procs(void) {
 	    (PFNGLFRAMEBUFFERTEXTUREPROC)_rb_gl_get_proc_address("glFramebufferTexture");
 	glFramebufferRenderbuffer =
 	    (PFNGLFRAMEBUFFERRENDERBUFFERPROC)_rb_gl_get_proc_address("glFramebufferRenderbuffer");
+	glBlitFramebuffer = (PFNGLBLITFRAMEBUFFERPROC)_rb_gl_get_proc_address("glBlitFramebuffer");
 	if (!glBindFramebuffer || !glDeleteFramebuffers || !glGenFramebuffers ||
 	    !glCheckFramebufferStatus || !glBindRenderbuffer || !glDeleteRenderbuffers ||
 	    !glGenRenderbuffers || !glRenderbufferStorage || !glFramebufferTexture ||
-	    !glFramebufferRenderbuffer) {
+	    !glFramebufferRenderbuffer || !glBlitFramebuffer) {
 		log_error(HASH_RENDER, ERROR_UNSUPPORTED,
 		          STRING_CONST("Unable to get GL procs for frame buffers"));
 		return false;
@@ -362,6 +438,27 @@ _rb_gl_get_arrays_procs(void) {
 	return true;
 }
 
+bool
+_rb_gl_get_vertex_binding_procs(void) {
+	// Optional, requires GL_ARB_vertex_attrib_binding and GL_ARB_multi_bind (core in 4.4)
+#ifndef GL_GLEXT_PROTOTYPES
+	glBindVertexBuffers =
+	    (PFNGLBINDVERTEXBUFFERSPROC)_rb_gl_get_proc_address("glBindVertexBuffers");
+	glVertexAttribFormat =
+	    (PFNGLVERTEXATTRIBFORMATPROC)_rb_gl_get_proc_address("glVertexAttribFormat");
+	glVertexAttribBinding =
+	    (PFNGLVERTEXATTRIBBINDINGPROC)_rb_gl_get_proc_address("glVertexAttribBinding");
+	return glBindVertexBuffers && glVertexAttribFormat && glVertexAttribBinding;
+#elif defined(GL_VERSION_4_4)
+	GLint major = 0, minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	return (major > 4) || ((major == 4) && (minor >= 4));
+#else
+	return false;
+#endif
+}
+
 bool
 _rb_gl_get_standard_procs(unsigned int major, unsigned int minor) {
 	if ((major > 1) || ((major == 1) && (minor >= 4))) {
@@ -381,6 +478,14 @@ _rb_gl_get_standard_procs(unsigned int major, unsigned int minor) {
 	if (major >= 4) {
 		if (!_rb_gl_get_arrays_procs())
 			return false;
+		if (!_rb_gl_get_buffer_copy_procs())
+			return false;
+		if (!_rb_gl_get_texture_buffer_procs())
+			return false;
+		if (!_rb_gl_get_sync_procs())
+			return false;
+		if (!_rb_gl_get_timer_query_procs())
+			return false;
 	}
 	return true;
 }
@@ -52,6 +52,18 @@ extern PFNGLUNMAPBUFFERPROC glUnmapBuffer;
 extern PFNGLGETBUFFERPARAMETERIVPROC glGetBufferParameteriv;
 extern PFNGLGETBUFFERPOINTERVPROC glGetBufferPointerv;
 
+extern PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+extern PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData;
+
+extern PFNGLTEXBUFFERPROC glTexBuffer;
+
+extern PFNGLQUERYCOUNTERPROC glQueryCounter;
+extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
+
+extern PFNGLFENCESYNCPROC glFenceSync;
+extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+extern PFNGLDELETESYNCPROC glDeleteSync;
+
 extern PFNGLBLENDEQUATIONSEPARATEPROC glBlendEquationSeparate;
 extern PFNGLSTENCILOPSEPARATEPROC glStencilOpSeparate;
 extern PFNGLSTENCILFUNCSEPARATEPROC glStencilFuncSeparate;
@@ -110,11 +122,16 @@ extern PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers;
 extern PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage;
 extern PFNGLFRAMEBUFFERTEXTUREPROC glFramebufferTexture;
 extern PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer;
+extern PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
 
 extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
 extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
 
+extern PFNGLBINDVERTEXBUFFERSPROC glBindVertexBuffers;
+extern PFNGLVERTEXATTRIBFORMATPROC glVertexAttribFormat;
+extern PFNGLVERTEXATTRIBBINDINGPROC glVertexAttribBinding;
+
 extern PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
 extern PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl;
 
@@ -134,6 +151,18 @@ _rb_gl_get_query_procs(void);
 RENDER_EXTERN bool
 _rb_gl_get_buffer_procs(void);
 
+RENDER_EXTERN bool
+_rb_gl_get_buffer_copy_procs(void);
+
+RENDER_EXTERN bool
+_rb_gl_get_texture_buffer_procs(void);
+
+RENDER_EXTERN bool
+_rb_gl_get_sync_procs(void);
+
+RENDER_EXTERN bool
+_rb_gl_get_timer_query_procs(void);
+
 RENDER_EXTERN bool
 _rb_gl_get_shader_procs(void);
 
@@ -143,6 +172,9 @@ _rb_gl_get_framebuffer_procs(void);
 RENDER_EXTERN bool
 _rb_gl_get_arrays_procs(void);
 
+RENDER_EXTERN bool
+_rb_gl_get_vertex_binding_procs(void);
+
 RENDER_EXTERN bool
 _rb_gl_get_standard_procs(unsigned int major, unsigned int minor);
 
@@ -186,6 +218,9 @@ _rb_gl_deallocate_target(render_backend_t* backend, render_target_t* target);
 RENDER_EXTERN bool
 _rb_gl_activate_target(render_backend_t* backend, render_target_t* target);
 
+RENDER_EXTERN void
+_rb_gl_blit_target(render_backend_t* backend, render_target_t* target, render_command_t* command);
+
 RENDER_EXTERN bool
 _rb_gl_upload_texture(render_backend_t* backend, render_texture_t* texture, const void* buffer,
                       size_t size);
@@ -168,6 +168,10 @@ render_import_glsl_shader(stream_t* stream, const uuid_t uuid, const char* type,
 					parameter_dim = glsl_dim_from_token(namestr);
 
 				namestr = glsl_name_from_token(namestr);
+				if (string_equal(STRING_ARGS(namestr), STRING_CONST("palette")) &&
+				    ((parameter_type == RENDERPARAMETER_MATRIX) ||
+				     (parameter_type == RENDERPARAMETER_TEXTURE)))
+					parameter_type = RENDERPARAMETER_PALETTE;
 				typestr = string_to_const(string_from_uint(
 				    typebuf, sizeof(typebuf), (unsigned int)parameter_type, false, 0, 0));
 				dimstr = string_to_const(string_from_uint(
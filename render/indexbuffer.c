@@ -28,8 +28,8 @@ render_indexbuffer_allocate(render_backend_t* backend, render_usage_t usage, siz
 	FOUNDATION_ASSERT(format < INDEXFORMAT_NUMTYPES);
 	size_t format_size = format ? (format * 2) : 1;
 
-	render_indexbuffer_t* buffer = memory_allocate(HASH_RENDER, sizeof(render_indexbuffer_t), 0,
-	                                               MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	render_indexbuffer_t* buffer =
+	    render_pool_allocate(&_render_buffer_pool, sizeof(render_indexbuffer_t));
 	buffer->backend = backend;
 	buffer->usage = (uint8_t)usage;
 	buffer->buffertype = RENDERBUFFER_INDEX;
@@ -83,17 +83,15 @@ render_indexbuffer_upload(render_indexbuffer_t* buffer) {
 
 void
 render_indexbuffer_free(render_indexbuffer_t* buffer, bool sys, bool aux) {
-	buffer->backend->vtable.deallocate_buffer(buffer->backend, (render_buffer_t*)buffer, sys, aux);
+	render_buffer_free((render_buffer_t*)buffer, sys, aux);
 }
 
 void
-render_indexbuffer_restore(render_indexbuffer_t* buffer) {
-	buffer->backend->vtable.allocate_buffer(buffer->backend, (render_buffer_t*)buffer);
-
-	//...
-	// All loadable resources should have a stream identifier, an offset and a size
-	// to be able to repoen the stream and read the raw buffer back
-	//...
+render_indexbuffer_set_discard(render_indexbuffer_t* buffer, const uuid_t source, size_t offset) {
+	render_buffer_set_discard((render_buffer_t*)buffer, source, offset);
+}
 
-	buffer->flags |= RENDERBUFFER_DIRTY;
+void
+render_indexbuffer_restore(render_indexbuffer_t* buffer) {
+	render_buffer_restore((render_buffer_t*)buffer);
 }
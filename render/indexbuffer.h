@@ -47,5 +47,15 @@ render_indexbuffer_upload(render_indexbuffer_t* buffer);
 RENDER_API void
 render_indexbuffer_free(render_indexbuffer_t* buffer, bool sys, bool aux);
 
+/*! Opt-in to drop the system memory store of a static buffer after upload. The data is
+restored on demand from the given resource static stream, or from a compressed spill
+cache if source is a null uuid, when the buffer is locked or restored after context loss.
+Data without source that does not compress keeps its store, since a raw copy saves nothing
+\param buffer Buffer
+\param source Resource the buffer data originates from, null uuid to use spill cache
+\param offset Offset of buffer data in resource static stream */
+RENDER_API void
+render_indexbuffer_set_discard(render_indexbuffer_t* buffer, const uuid_t source, size_t offset);
+
 RENDER_API void
 render_indexbuffer_restore(render_indexbuffer_t* buffer);
@@ -33,24 +33,112 @@
 RENDER_EXTERN bool _render_api_disabled[];
 RENDER_EXTERN render_config_t _render_config;
 RENDER_EXTERN render_backend_t** _render_backends;
+RENDER_EXTERN render_pool_t _render_target_pool;
+RENDER_EXTERN render_pool_t _render_buffer_pool;
+RENDER_EXTERN render_pool_t _render_program_pool;
+
+typedef enum render_destroy_type_t {
+	RENDERDESTROY_BUFFER = 0,
+	RENDERDESTROY_TEXTURE,
+	RENDERDESTROY_SHADER,
+	RENDERDESTROY_PROGRAM,
+	RENDERDESTROY_TARGET
+} render_destroy_type_t;
 
 // INTERNAL FUNCTIONS
 
 RENDER_EXTERN void
 render_target_initialize_framebuffer(render_target_t* target, render_backend_t* backend);
 
+RENDER_EXTERN int
+render_pool_initialize(render_pool_t* pool, size_t size, size_t capacity);
+
+RENDER_EXTERN void
+render_pool_finalize(render_pool_t* pool);
+
+RENDER_EXTERN void*
+render_pool_allocate(render_pool_t* pool, size_t size);
+
+RENDER_EXTERN void
+render_pool_deallocate(render_pool_t* pool, void* ptr);
+
+RENDER_EXTERN render_handle_t
+render_pool_handle(const render_pool_t* pool, const void* ptr);
+
+RENDER_EXTERN void*
+render_pool_resolve(const render_pool_t* pool, render_handle_t handle);
+
+RENDER_EXTERN void
+render_trace_finalize(void);
+
+RENDER_EXTERN void
+render_backend_queue_destroy(render_backend_t* backend, render_destroy_t* entry,
+                             render_destroy_type_t type, void* object);
+
+RENDER_EXTERN bool
+render_backend_dispatch_matches(render_backend_t* backend, size_t offset,
+                                render_target_t* target, render_context_t** contexts,
+                                size_t num_contexts);
+
+RENDER_EXTERN bool
+render_backend_dispatch_frame(render_backend_t* backend, render_target_t* target,
+                              render_context_t** contexts, size_t num_contexts, bool skip);
+
+RENDER_EXTERN void
+render_backend_destroy_queued(render_backend_t* backend, bool force);
+
+RENDER_EXTERN void
+render_backend_memory_track(render_backend_t* backend, render_resource_type_t type,
+                            unsigned int usage, int64_t system, int64_t gpu);
+
+RENDER_EXTERN void
+render_backend_memory_track_buffer(render_buffer_t* buffer, int64_t system, int64_t gpu);
+
 RENDER_EXTERN void
 render_buffer_deallocate(render_buffer_t* buffer);
 
+RENDER_EXTERN void
+render_buffer_destroy(render_buffer_t* buffer);
+
+RENDER_EXTERN void
+render_texture_destroy(render_texture_t* texture);
+
+RENDER_EXTERN void
+render_shader_destroy(render_shader_t* shader);
+
+RENDER_EXTERN void
+render_program_destroy(render_program_t* program);
+
 RENDER_EXTERN void
 render_buffer_upload(render_buffer_t* buffer);
 
+RENDER_EXTERN void
+render_buffer_upload_batch(render_backend_t* backend, render_buffer_t** buffers, size_t num_buffers);
+
+RENDER_EXTERN uint32_t
+render_buffer_generation(void);
+
 RENDER_EXTERN void
 render_buffer_lock(render_buffer_t* buffer, unsigned int lock);
 
 RENDER_EXTERN void
 render_buffer_unlock(render_buffer_t* buffer);
 
+RENDER_EXTERN void
+render_buffer_set_discard(render_buffer_t* buffer, const uuid_t source, size_t offset);
+
+RENDER_EXTERN void
+render_buffer_free(render_buffer_t* buffer, bool sys, bool aux);
+
+RENDER_EXTERN void
+render_buffer_restore(render_buffer_t* buffer);
+
+RENDER_EXTERN int
+render_vertex_decl_table_initialize(void);
+
+RENDER_EXTERN void
+render_vertex_decl_table_finalize(void);
+
 RENDER_EXTERN render_shader_t*
 render_shader_load_raw(render_backend_t* backend, const uuid_t uuid);
 
@@ -59,3 +147,11 @@ render_program_load_raw(render_backend_t* backend, const uuid_t uuid);
 
 RENDER_EXTERN render_texture_t*
 render_texture_load_raw(render_backend_t* backend, const uuid_t uuid);
+
+//! Parameter buffer of a render command, substituted by the current view in a multi-view dispatch
+static FOUNDATION_FORCEINLINE render_parameterbuffer_t*
+render_backend_command_parameterbuffer(render_backend_t* backend, const render_command_t* command) {
+	if (backend->view && command->view)
+		return backend->view->parameters[command->view - 1];
+	return command->data.render.parameterbuffer;
+}
@@ -0,0 +1,590 @@
+/* mesh.c  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+
+#include <render/render.h>
+#include <render/internal.h>
+
+#include <resource/stream.h>
+#include <resource/compile.h>
+#include <resource/local.h>
+#include <resource/source.h>
+
+//! Simulated post-transform cache size used for triangle scoring
+#define RENDER_MESH_CACHE_SIZE 32
+//! Valence scores are tabulated up to this count
+#define RENDER_MESH_VALENCE_SIZE 32
+
+#define RENDER_MESH_INVALID ((uint32_t)-1)
+
+static float
+render_mesh_vertex_score(const float* cache_score, const float* valence_score, uint32_t position,
+                         uint32_t valence) {
+	if (!valence)
+		return -1.0f;
+	float score = (position != RENDER_MESH_INVALID) ? cache_score[position] : 0.0f;
+	return score + valence_score[(valence < RENDER_MESH_VALENCE_SIZE) ? valence :
+	                                                                     RENDER_MESH_VALENCE_SIZE - 1];
+}
+
+void
+render_mesh_optimize_vertex_cache(uint32_t* indices, size_t num_indices, size_t num_vertices) {
+	// Linear-speed vertex cache optimization as described by Tom Forsyth
+	const size_t num_triangles = num_indices / 3;
+	if (!num_triangles || !num_vertices)
+		return;
+
+	float cache_score[RENDER_MESH_CACHE_SIZE];
+	float valence_score[RENDER_MESH_VALENCE_SIZE];
+	for (unsigned int ipos = 0; ipos < RENDER_MESH_CACHE_SIZE; ++ipos) {
+		if (ipos < 3) {
+			// Vertices used by the last triangle get a fixed score to avoid
+			// favoring triangles that share an edge with the last one
+			cache_score[ipos] = 0.75f;
+		} else {
+			float decay = 1.0f - ((float)(ipos - 3) / (float)(RENDER_MESH_CACHE_SIZE - 3));
+			cache_score[ipos] = decay * (float)math_sqrt((real)decay);
+		}
+	}
+	valence_score[0] = 0;
+	for (unsigned int ival = 1; ival < RENDER_MESH_VALENCE_SIZE; ++ival)
+		valence_score[ival] = 2.0f / (float)math_sqrt((real)ival);
+
+	uint32_t* valence = memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_vertices, 0,
+	                                    MEMORY_TEMPORARY | MEMORY_ZERO_INITIALIZED);
+	uint32_t* offset =
+	    memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_vertices, 0, MEMORY_TEMPORARY);
+	uint32_t* position =
+	    memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_vertices, 0, MEMORY_TEMPORARY);
+	float* vertex_score =
+	    memory_allocate(HASH_RENDER, sizeof(float) * num_vertices, 0, MEMORY_TEMPORARY);
+	uint32_t* adjacency =
+	    memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_triangles * 3, 0, MEMORY_TEMPORARY);
+	float* triangle_score =
+	    memory_allocate(HASH_RENDER, sizeof(float) * num_triangles, 0, MEMORY_TEMPORARY);
+	uint8_t* emitted = memory_allocate(HASH_RENDER, num_triangles, 0,
+	                                   MEMORY_TEMPORARY | MEMORY_ZERO_INITIALIZED);
+	uint32_t* output =
+	    memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_triangles * 3, 0, MEMORY_TEMPORARY);
+
+	for (size_t iidx = 0; iidx < num_triangles * 3; ++iidx) {
+		FOUNDATION_ASSERT(indices[iidx] < num_vertices);
+		++valence[indices[iidx]];
+	}
+
+	// Build vertex to triangle adjacency, using position as fill cursor
+	uint32_t total = 0;
+	for (size_t ivert = 0; ivert < num_vertices; ++ivert) {
+		offset[ivert] = total;
+		position[ivert] = total;
+		total += valence[ivert];
+	}
+	for (size_t itri = 0; itri < num_triangles; ++itri) {
+		for (unsigned int icorner = 0; icorner < 3; ++icorner)
+			adjacency[position[indices[(itri * 3) + icorner]]++] = (uint32_t)itri;
+	}
+
+	for (size_t ivert = 0; ivert < num_vertices; ++ivert) {
+		position[ivert] = RENDER_MESH_INVALID;
+		vertex_score[ivert] =
+		    render_mesh_vertex_score(cache_score, valence_score, RENDER_MESH_INVALID, valence[ivert]);
+	}
+
+	uint32_t best_triangle = 0;
+	float best_score = -1.0f;
+	for (size_t itri = 0; itri < num_triangles; ++itri) {
+		const uint32_t* corner = indices + (itri * 3);
+		triangle_score[itri] =
+		    vertex_score[corner[0]] + vertex_score[corner[1]] + vertex_score[corner[2]];
+		if (triangle_score[itri] > best_score) {
+			best_score = triangle_score[itri];
+			best_triangle = (uint32_t)itri;
+		}
+	}
+
+	uint32_t cache[RENDER_MESH_CACHE_SIZE + 3];
+	uint32_t next_cache[RENDER_MESH_CACHE_SIZE + 3];
+	size_t cache_count = 0;
+	size_t scan = 0;
+
+	for (size_t iemit = 0; iemit < num_triangles; ++iemit) {
+		if (best_triangle == RENDER_MESH_INVALID) {
+			// No candidate in cache, continue with first remaining triangle in input order
+			while (emitted[scan])
+				++scan;
+			best_triangle = (uint32_t)scan;
+		}
+
+		const uint32_t* corner = indices + (best_triangle * 3);
+		emitted[best_triangle] = 1;
+		memcpy(output + (iemit * 3), corner, sizeof(uint32_t) * 3);
+
+		size_t next_count = 0;
+		for (unsigned int icorner = 0; icorner < 3; ++icorner) {
+			uint32_t vertex = corner[icorner];
+
+			// Remove emitted triangle from vertex adjacency
+			uint32_t* list = adjacency + offset[vertex];
+			for (uint32_t iadj = 0, adjsize = valence[vertex]; iadj < adjsize; ++iadj) {
+				if (list[iadj] == best_triangle) {
+					list[iadj] = list[adjsize - 1];
+					--valence[vertex];
+					break;
+				}
+			}
+
+			// Move to front of cache, skip duplicates of degenerate triangles
+			if ((next_count == 0) || ((next_cache[0] != vertex) && ((next_count == 1) || (next_cache[1] != vertex))))
+				next_cache[next_count++] = vertex;
+		}
+		for (size_t icache = 0; icache < cache_count; ++icache) {
+			uint32_t vertex = cache[icache];
+			if ((vertex != corner[0]) && (vertex != corner[1]) && (vertex != corner[2]))
+				next_cache[next_count++] = vertex;
+		}
+
+		// Update scores of vertices in or pushed out of cache, then pick the best
+		// candidate among their remaining triangles
+		for (size_t icache = 0; icache < next_count; ++icache) {
+			uint32_t vertex = next_cache[icache];
+			position[vertex] = (icache < RENDER_MESH_CACHE_SIZE) ? (uint32_t)icache : RENDER_MESH_INVALID;
+			vertex_score[vertex] =
+			    render_mesh_vertex_score(cache_score, valence_score, position[vertex], valence[vertex]);
+		}
+
+		best_triangle = RENDER_MESH_INVALID;
+		best_score = -1.0f;
+		for (size_t icache = 0; icache < next_count; ++icache) {
+			uint32_t vertex = next_cache[icache];
+			const uint32_t* list = adjacency + offset[vertex];
+			for (uint32_t iadj = 0, adjsize = valence[vertex]; iadj < adjsize; ++iadj) {
+				uint32_t triangle = list[iadj];
+				const uint32_t* tricorner = indices + (triangle * 3);
+				float score = vertex_score[tricorner[0]] + vertex_score[tricorner[1]] +
+				              vertex_score[tricorner[2]];
+				triangle_score[triangle] = score;
+				if (score > best_score) {
+					best_score = score;
+					best_triangle = triangle;
+				}
+			}
+		}
+
+		cache_count = (next_count < RENDER_MESH_CACHE_SIZE) ? next_count : RENDER_MESH_CACHE_SIZE;
+		memcpy(cache, next_cache, sizeof(uint32_t) * cache_count);
+	}
+
+	memcpy(indices, output, sizeof(uint32_t) * num_triangles * 3);
+
+	memory_deallocate(output);
+	memory_deallocate(emitted);
+	memory_deallocate(triangle_score);
+	memory_deallocate(adjacency);
+	memory_deallocate(vertex_score);
+	memory_deallocate(position);
+	memory_deallocate(offset);
+	memory_deallocate(valence);
+}
+
+void
+render_mesh_optimize_overdraw(uint32_t* indices, size_t num_indices, const float* positions,
+                              size_t position_stride, size_t num_vertices) {
+	const size_t num_triangles = num_indices / 3;
+	if ((num_triangles < 2) || !num_vertices)
+		return;
+
+	// Split into clusters where all three vertices of a triangle miss the simulated cache,
+	// i.e. where the vertex cache optimizer restarted on a new region of the mesh
+	uint32_t* cluster_start =
+	    memory_allocate(HASH_RENDER, sizeof(uint32_t) * (num_triangles + 1), 0, MEMORY_TEMPORARY);
+	uint32_t* timestamp = memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_vertices, 0,
+	                                      MEMORY_TEMPORARY | MEMORY_ZERO_INITIALIZED);
+	uint32_t num_clusters = 0;
+	uint32_t time = RENDER_MESH_CACHE_SIZE + 1;
+	for (size_t itri = 0; itri < num_triangles; ++itri) {
+		unsigned int misses = 0;
+		for (unsigned int icorner = 0; icorner < 3; ++icorner) {
+			uint32_t vertex = indices[(itri * 3) + icorner];
+			if ((time - timestamp[vertex]) > RENDER_MESH_CACHE_SIZE) {
+				timestamp[vertex] = time++;
+				++misses;
+			}
+		}
+		if (!itri || (misses == 3))
+			cluster_start[num_clusters++] = (uint32_t)itri;
+	}
+	cluster_start[num_clusters] = (uint32_t)num_triangles;
+	memory_deallocate(timestamp);
+
+	if (num_clusters < 2) {
+		memory_deallocate(cluster_start);
+		return;
+	}
+
+	// Mesh centroid, area weighted
+	float* cluster_key = memory_allocate(HASH_RENDER, sizeof(float) * num_clusters, 0, MEMORY_TEMPORARY);
+	float* cluster_data =
+	    memory_allocate(HASH_RENDER, sizeof(float) * 7 * num_clusters, 0, MEMORY_TEMPORARY);
+	float mesh_centroid[3] = {0, 0, 0};
+	float mesh_area = 0;
+	for (uint32_t icluster = 0; icluster < num_clusters; ++icluster) {
+		float* data = cluster_data + (icluster * 7);
+		memset(data, 0, sizeof(float) * 7);
+		for (uint32_t itri = cluster_start[icluster]; itri < cluster_start[icluster + 1]; ++itri) {
+			const float* p0 = pointer_offset_const(positions, position_stride * indices[itri * 3]);
+			const float* p1 = pointer_offset_const(positions, position_stride * indices[(itri * 3) + 1]);
+			const float* p2 = pointer_offset_const(positions, position_stride * indices[(itri * 3) + 2]);
+			float e0[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			float e1[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+			float normal[3] = {(e0[1] * e1[2]) - (e0[2] * e1[1]), (e0[2] * e1[0]) - (e0[0] * e1[2]),
+			                   (e0[0] * e1[1]) - (e0[1] * e1[0])};
+			float area = (float)math_sqrt((real)((normal[0] * normal[0]) + (normal[1] * normal[1]) +
+			                                     (normal[2] * normal[2])));
+			for (unsigned int iaxis = 0; iaxis < 3; ++iaxis) {
+				float center = (p0[iaxis] + p1[iaxis] + p2[iaxis]) / 3.0f;
+				data[iaxis] += center * area;
+				data[3 + iaxis] += normal[iaxis];
+			}
+			data[6] += area;
+		}
+		for (unsigned int iaxis = 0; iaxis < 3; ++iaxis)
+			mesh_centroid[iaxis] += data[iaxis];
+		mesh_area += data[6];
+	}
+	if (mesh_area > 0) {
+		for (unsigned int iaxis = 0; iaxis < 3; ++iaxis)
+			mesh_centroid[iaxis] /= mesh_area;
+	}
+
+	// Sort clusters facing away from the mesh center first, they are likely to
+	// occlude clusters drawn later
+	for (uint32_t icluster = 0; icluster < num_clusters; ++icluster) {
+		const float* data = cluster_data + (icluster * 7);
+		float key = 0;
+		float normal_length = (float)math_sqrt(
+		    (real)((data[3] * data[3]) + (data[4] * data[4]) + (data[5] * data[5])));
+		if ((data[6] > 0) && (normal_length > 0)) {
+			for (unsigned int iaxis = 0; iaxis < 3; ++iaxis)
+				key += ((data[iaxis] / data[6]) - mesh_centroid[iaxis]) * data[3 + iaxis];
+			key /= normal_length;
+		}
+		cluster_key[icluster] = -key;
+	}
+
+	radixsort_t* sort = radixsort_allocate(RADIXSORT_FLOAT32, num_clusters);
+	const void* order = radixsort_sort(sort, cluster_key, num_clusters);
+
+	uint32_t* output =
+	    memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_triangles * 3, 0, MEMORY_TEMPORARY);
+	uint32_t* write = output;
+	for (uint32_t iorder = 0; iorder < num_clusters; ++iorder) {
+		uint32_t icluster = (sort->indextype == RADIXSORT_INDEX16) ?
+		                        ((const uint16_t*)order)[iorder] :
+		                        ((const uint32_t*)order)[iorder];
+		size_t count = (cluster_start[icluster + 1] - cluster_start[icluster]) * 3;
+		memcpy(write, indices + (cluster_start[icluster] * 3), sizeof(uint32_t) * count);
+		write += count;
+	}
+	memcpy(indices, output, sizeof(uint32_t) * num_triangles * 3);
+
+	radixsort_deallocate(sort);
+	memory_deallocate(output);
+	memory_deallocate(cluster_data);
+	memory_deallocate(cluster_key);
+	memory_deallocate(cluster_start);
+}
+
+size_t
+render_mesh_optimize_vertex_fetch(void* vertices, size_t vertex_size, size_t num_vertices,
+                                  uint32_t* indices, size_t num_indices) {
+	if (!num_vertices || !num_indices)
+		return 0;
+
+	uint32_t* remap =
+	    memory_allocate(HASH_RENDER, sizeof(uint32_t) * num_vertices, 0, MEMORY_TEMPORARY);
+	memset(remap, 0xFF, sizeof(uint32_t) * num_vertices);
+
+	uint32_t used = 0;
+	for (size_t iidx = 0; iidx < num_indices; ++iidx) {
+		uint32_t vertex = indices[iidx];
+		FOUNDATION_ASSERT(vertex < num_vertices);
+		if (remap[vertex] == RENDER_MESH_INVALID)
+			remap[vertex] = used++;
+		indices[iidx] = remap[vertex];
+	}
+
+	void* reordered = memory_allocate(HASH_RENDER, vertex_size * used, 0, MEMORY_TEMPORARY);
+	for (size_t ivert = 0; ivert < num_vertices; ++ivert) {
+		if (remap[ivert] != RENDER_MESH_INVALID)
+			memcpy(pointer_offset(reordered, vertex_size * remap[ivert]),
+			       pointer_offset(vertices, vertex_size * ivert), vertex_size);
+	}
+	memcpy(vertices, reordered, vertex_size * used);
+
+	memory_deallocate(reordered);
+	memory_deallocate(remap);
+
+	return used;
+}
+
+render_index_format_t
+render_mesh_index_format(size_t num_vertices) {
+	return (num_vertices <= 0x10000) ? INDEXFORMAT_USHORT : INDEXFORMAT_UINT;
+}
+
+void
+render_mesh_store_indices(void* destination, render_index_format_t format,
+                          const uint32_t* indices, size_t num_indices) {
+	if (format == INDEXFORMAT_UINT) {
+		memcpy(destination, indices, sizeof(uint32_t) * num_indices);
+	} else if (format == INDEXFORMAT_USHORT) {
+		uint16_t* out = destination;
+		for (size_t iidx = 0; iidx < num_indices; ++iidx)
+			out[iidx] = (uint16_t)indices[iidx];
+	} else {
+		uint8_t* out = destination;
+		for (size_t iidx = 0; iidx < num_indices; ++iidx)
+			out[iidx] = (uint8_t)indices[iidx];
+	}
+}
+
+bool
+render_mesh_load(render_backend_t* backend, const uuid_t uuid,
+                 render_vertexbuffer_t** vertexbuffer, render_indexbuffer_t** indexbuffer) {
+	const hash_t mesh_type = hash(STRING_CONST("mesh"));
+	uint64_t platform = render_backend_resource_platform(backend);
+	render_vertexbuffer_t* vbuffer = nullptr;
+	render_indexbuffer_t* ibuffer = nullptr;
+	stream_t* stream = nullptr;
+	resource_header_t header;
+	render_vertex_decl_t decl;
+	bool recompiled = false;
+	bool success = false;
+
+	error_context_declare_local(
+	    char uuidbuf[40];
+	    const string_t uuidstr = string_from_uuid(uuidbuf, sizeof(uuidbuf), uuid)
+	);
+	error_context_push(STRING_CONST("loading mesh"), STRING_ARGS(uuidstr));
+
+retry:
+
+	stream = resource_stream_open_static(uuid, platform);
+	if (!stream)
+		goto finalize;
+
+	header = resource_stream_read_header(stream);
+	if ((header.type != mesh_type) || (header.version != RENDER_MESH_RESOURCE_VERSION)) {
+		if (!recompiled) {
+			log_warnf(HASH_RENDER, WARNING_INVALID_VALUE,
+			          STRING_CONST("Got unexpected type/version: %" PRIx64 " : %u"),
+			          (uint64_t)header.type, (uint32_t)header.version);
+			stream_deallocate(stream);
+			stream = nullptr;
+			recompiled = resource_compile(uuid, platform);
+			if (recompiled)
+				goto retry;
+			log_error(HASH_RENDER, ERROR_INTERNAL_FAILURE, STRING_CONST("Failed recompiling mesh"));
+		}
+		goto finalize;
+	}
+
+	stream_read(stream, &decl, sizeof(decl));
+	size_t num_vertices = stream_read_uint32(stream);
+	size_t num_indices = stream_read_uint32(stream);
+	render_index_format_t format = (render_index_format_t)stream_read_uint32(stream);
+	if (format >= INDEXFORMAT_NUMTYPES)
+		goto finalize;
+
+	size_t vertex_size = render_vertex_decl_binding_stride(&decl, 0) * num_vertices;
+	size_t index_size = (format ? ((size_t)format * 2) : 1) * num_indices;
+
+	size_t vertex_offset = stream_tell(stream);
+	vbuffer = render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, num_vertices, vertex_size,
+	                                       &decl, nullptr, 0);
+	render_vertexbuffer_lock(vbuffer, RENDERBUFFER_LOCK_WRITE);
+	size_t read = stream_read(stream, vbuffer->access, vertex_size);
+	render_vertexbuffer_unlock(vbuffer);
+	if (read != vertex_size)
+		goto finalize;
+
+	size_t index_offset = stream_tell(stream);
+	ibuffer = render_indexbuffer_allocate(backend, RENDERUSAGE_STATIC, num_indices, index_size,
+	                                      format, nullptr, 0);
+	render_indexbuffer_lock(ibuffer, RENDERBUFFER_LOCK_WRITE);
+	read = stream_read(stream, ibuffer->access, index_size);
+	render_indexbuffer_unlock(ibuffer);
+	if (read != index_size)
+		goto finalize;
+
+	render_vertexbuffer_set_discard(vbuffer, uuid, vertex_offset);
+	render_indexbuffer_set_discard(ibuffer, uuid, index_offset);
+
+	success = true;
+
+finalize:
+	if (stream)
+		stream_deallocate(stream);
+
+	if (!success) {
+		render_vertexbuffer_deallocate(vbuffer);
+		render_indexbuffer_deallocate(ibuffer);
+		vbuffer = nullptr;
+		ibuffer = nullptr;
+	}
+
+	*vertexbuffer = vbuffer;
+	*indexbuffer = ibuffer;
+
+	error_context_pop();
+
+	return success;
+}
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+
+int
+render_mesh_compile(const uuid_t uuid, uint64_t platform, resource_source_t* source,
+                    const uint256_t source_hash, const char* type, size_t type_length) {
+	int result = -1;
+	void* sourcebuffer = nullptr;
+	uint32_t* indices = nullptr;
+	void* vertices = nullptr;
+	void* indexdata = nullptr;
+	render_vertex_decl_t decl;
+
+	if (!string_equal(type, type_length, STRING_CONST("mesh")))
+		return -1;
+
+	error_context_declare_local(char uuidbuf[40]; const string_t uuidstr = string_from_uuid(
+	                                                  uuidbuf, sizeof(uuidbuf), uuid));
+	error_context_push(STRING_CONST("compiling mesh"), STRING_ARGS(uuidstr));
+
+	resource_change_t* sourcechange = resource_source_get(source, HASH_SOURCE, platform);
+	if (!sourcechange || !(sourcechange->flags & RESOURCE_SOURCEFLAG_BLOB)) {
+		log_error(HASH_RESOURCE, ERROR_INVALID_VALUE, STRING_CONST("Missing mesh source blob"));
+		goto finalize;
+	}
+
+	size_t source_size = sourcechange->value.blob.size;
+	sourcebuffer = memory_allocate(HASH_RESOURCE, source_size, 0, MEMORY_PERSISTENT);
+	if (!resource_source_read_blob(uuid, HASH_SOURCE, platform, sourcechange->value.blob.checksum,
+	                               sourcebuffer, source_size)) {
+		log_error(HASH_RESOURCE, ERROR_SYSTEM_CALL_FAIL,
+		          STRING_CONST("Failed to read full source blob"));
+		goto finalize;
+	}
+
+	const size_t header_size = sizeof(render_vertex_decl_t) + (sizeof(uint32_t) * 2);
+	if (source_size < header_size) {
+		log_error(HASH_RESOURCE, ERROR_INVALID_VALUE, STRING_CONST("Invalid mesh source blob"));
+		goto finalize;
+	}
+
+	uint32_t count[2];
+	memcpy(&decl, sourcebuffer, sizeof(decl));
+	memcpy(count, pointer_offset(sourcebuffer, sizeof(decl)), sizeof(count));
+	size_t num_vertices = count[0];
+	size_t num_indices = count[1];
+	size_t vertex_size = render_vertex_decl_binding_stride(&decl, 0);
+	if (!vertex_size || (num_indices % 3) ||
+	    (source_size != (header_size + (vertex_size * num_vertices) + (sizeof(uint32_t) * num_indices)))) {
+		log_error(HASH_RESOURCE, ERROR_INVALID_VALUE, STRING_CONST("Invalid mesh source blob size"));
+		goto finalize;
+	}
+
+	vertices = memory_allocate(HASH_RESOURCE, vertex_size * num_vertices, 0, MEMORY_PERSISTENT);
+	indices = memory_allocate(HASH_RESOURCE, sizeof(uint32_t) * num_indices, 0, MEMORY_PERSISTENT);
+	memcpy(vertices, pointer_offset(sourcebuffer, header_size), vertex_size * num_vertices);
+	memcpy(indices, pointer_offset(sourcebuffer, header_size + (vertex_size * num_vertices)),
+	       sizeof(uint32_t) * num_indices);
+	for (size_t iidx = 0; iidx < num_indices; ++iidx) {
+		if (indices[iidx] >= num_vertices) {
+			log_error(HASH_RESOURCE, ERROR_INVALID_VALUE, STRING_CONST("Mesh index out of range"));
+			goto finalize;
+		}
+	}
+
+	render_mesh_optimize_vertex_cache(indices, num_indices, num_vertices);
+
+	const render_vertex_attribute_t* position = decl.attribute + VERTEXATTRIBUTE_POSITION;
+	if ((position->format == VERTEXFORMAT_FLOAT3) || (position->format == VERTEXFORMAT_FLOAT4))
+		render_mesh_optimize_overdraw(indices, num_indices,
+		                              pointer_offset(vertices, position->offset), vertex_size,
+		                              num_vertices);
+
+	num_vertices =
+	    render_mesh_optimize_vertex_fetch(vertices, vertex_size, num_vertices, indices, num_indices);
+
+	resource_change_t* quantizechange =
+	    resource_source_get(source, hash(STRING_CONST("quantize")), platform);
+	if (quantizechange && (quantizechange->flags & RESOURCE_SOURCEFLAG_VALUE) &&
+	    string_equal(STRING_ARGS(quantizechange->value.value), STRING_CONST("true"))) {
+		render_vertex_decl_t quantized_decl;
+		if (render_vertex_decl_quantize(&quantized_decl, &decl)) {
+			size_t quantized_size = render_vertex_decl_binding_stride(&quantized_decl, 0);
+			void* quantized = memory_allocate(HASH_RESOURCE, quantized_size * num_vertices, 0,
+			                                  MEMORY_PERSISTENT);
+			render_vertex_decl_convert(&quantized_decl, quantized, &decl, vertices, num_vertices);
+			memory_deallocate(vertices);
+			vertices = quantized;
+			vertex_size = quantized_size;
+			decl = quantized_decl;
+		}
+	}
+
+	render_index_format_t format = render_mesh_index_format(num_vertices);
+	size_t index_size = (size_t)format * 2 * num_indices;
+	indexdata = memory_allocate(HASH_RESOURCE, index_size ? index_size : 1, 0, MEMORY_PERSISTENT);
+	render_mesh_store_indices(indexdata, format, indices, num_indices);
+
+	stream_t* stream = resource_local_create_static(uuid, platform);
+	if (stream) {
+		resource_header_t header = {.type = hash(type, type_length),
+		                            .version = RENDER_MESH_RESOURCE_VERSION,
+		                            .source_hash = source_hash};
+		resource_stream_write_header(stream, header);
+		stream_write(stream, &decl, sizeof(decl));
+		stream_write_uint32(stream, (uint32_t)num_vertices);
+		stream_write_uint32(stream, (uint32_t)num_indices);
+		stream_write_uint32(stream, (uint32_t)format);
+		stream_write(stream, vertices, vertex_size * num_vertices);
+		stream_write(stream, indexdata, index_size);
+		string_const_t streampath = stream_path(stream);
+		log_infof(HASH_RESOURCE, STRING_CONST("Wrote compiled mesh static stream: %.*s"),
+		          STRING_FORMAT(streampath));
+		stream_deallocate(stream);
+		result = 0;
+	} else {
+		log_errorf(HASH_RESOURCE, ERROR_SYSTEM_CALL_FAIL,
+		           STRING_CONST("Unable to create static resource stream"));
+	}
+
+finalize:
+	memory_deallocate(indexdata);
+	memory_deallocate(indices);
+	memory_deallocate(vertices);
+	memory_deallocate(sourcebuffer);
+
+	error_context_pop();
+
+	return result;
+}
+
+#endif
@@ -0,0 +1,110 @@
+/* mesh.h  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file mesh.h
+    Mesh optimization and compiled mesh resources. Mesh source is a blob holding a
+    vertex declaration, a 32-bit vertex count, a 32-bit index count, vertex data and
+    32-bit triangle list indices. The compiled resource holds the optimized vertex
+    and index buffer data with the narrowest index format possible. If the source value
+    "quantize" is "true", float attributes are converted to the compact formats given by
+    render_vertex_decl_quantize */
+
+#include <foundation/platform.h>
+
+#include <render/types.h>
+
+/*! Reorder triangles to maximize post-transform vertex cache hits
+\param indices Triangle list indices, reordered in place
+\param num_indices Number of indices
+\param num_vertices Number of vertices referenced by indices */
+RENDER_API void
+render_mesh_optimize_vertex_cache(uint32_t* indices, size_t num_indices, size_t num_vertices);
+
+/*! Reorder triangle clusters to reduce overdraw, outward facing clusters first. Should be
+called after render_mesh_optimize_vertex_cache, cluster boundaries are placed where the
+vertex cache is cold to preserve cache efficiency
+\param indices Triangle list indices, reordered in place
+\param num_indices Number of indices
+\param positions Float vertex positions (at least 3 components)
+\param position_stride Stride in bytes between positions
+\param num_vertices Number of vertices */
+RENDER_API void
+render_mesh_optimize_overdraw(uint32_t* indices, size_t num_indices, const float* positions,
+                              size_t position_stride, size_t num_vertices);
+
+/*! Reorder vertices in order of first use by indices for vertex fetch locality. Vertices
+not referenced by any index are removed
+\param vertices Vertex data, reordered in place
+\param vertex_size Size of a vertex in bytes
+\param num_vertices Number of vertices
+\param indices Indices, remapped in place
+\param num_indices Number of indices
+\return Number of vertices after optimization */
+RENDER_API size_t
+render_mesh_optimize_vertex_fetch(void* vertices, size_t vertex_size, size_t num_vertices,
+                                  uint32_t* indices, size_t num_indices);
+
+/*! Get the narrowest index format able to address the given number of vertices
+\param num_vertices Number of vertices
+\return Index format */
+RENDER_API render_index_format_t
+render_mesh_index_format(size_t num_vertices);
+
+/*! Store 32-bit indices in the given index format
+\param destination Destination index data
+\param format Index format
+\param indices Source indices
+\param num_indices Number of indices */
+RENDER_API void
+render_mesh_store_indices(void* destination, render_index_format_t format,
+                          const uint32_t* indices, size_t num_indices);
+
+/*! Load a compiled mesh resource into static vertex and index buffers. The buffers
+are set to discard their system memory store after upload, restoring from the
+resource stream on demand
+\param backend Backend
+\param uuid Mesh UUID
+\param vertexbuffer Receives vertex buffer
+\param indexbuffer Receives index buffer
+\return true if successful, false if error */
+RENDER_API bool
+render_mesh_load(render_backend_t* backend, const uuid_t uuid,
+                 render_vertexbuffer_t** vertexbuffer, render_indexbuffer_t** indexbuffer);
+
+#define RENDER_MESH_RESOURCE_VERSION 1
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+
+/* Compile mesh resource
+\param uuid Mesh UUID
+\param platform Resource platform
+\param source Mesh resource source representation
+\param type Type string
+\param type_length Length of type string
+\return 0 if successful, <0 if error */
+RENDER_API int
+render_mesh_compile(const uuid_t uuid, uint64_t platform, resource_source_t* source,
+                    const uint256_t source_hash, const char* type, size_t type_length);
+
+#else
+
+#define render_mesh_compile(uuid, platform, source, source_hash, type, type_length) (((void)sizeof(uuid)), ((void)sizeof(platform)), ((void)sizeof(source)), ((void)sizeof(source_hash)), ((void)sizeof(type)), ((void)sizeof(type_length)), -1)
+
+#endif
@@ -80,6 +80,7 @@ _rb_null_flip(render_backend_t* backend) {
 static void*
 _rb_null_allocate_buffer(render_backend_t* backend, render_buffer_t* buffer) {
 	FOUNDATION_UNUSED(backend);
+	render_backend_memory_track_buffer(buffer, (int64_t)buffer->buffersize, 0);
 	return memory_allocate(HASH_RENDER, buffer->buffersize, 16, MEMORY_PERSISTENT);
 }
 
@@ -87,14 +88,17 @@ static void
 _rb_null_deallocate_buffer(render_backend_t* backend, render_buffer_t* buffer, bool sys, bool aux) {
 	FOUNDATION_UNUSED(backend);
 	FOUNDATION_UNUSED(aux);
-	if (sys)
+	// State buffer store is embedded in the buffer
+	if (sys && buffer->store && (buffer->buffertype != RENDERBUFFER_STATE)) {
 		memory_deallocate(buffer->store);
+		render_backend_memory_track_buffer(buffer, -(int64_t)buffer->buffersize, 0);
+	}
 }
 
 static bool
 _rb_null_upload_buffer(render_backend_t* backend, render_buffer_t* buffer) {
 	FOUNDATION_UNUSED(backend);
-	FOUNDATION_UNUSED(buffer);
+	buffer->flags &= ~(uint32_t)RENDERBUFFER_DIRTY;
 	return true;
 }
 
@@ -190,6 +194,26 @@ _rb_null_deallocate_target(render_backend_t* backend, render_target_t* target) {
 	FOUNDATION_UNUSED(target);
 }
 
+static unsigned int
+_rb_null_timer_begin(render_backend_t* backend) {
+	FOUNDATION_UNUSED(backend);
+	return 0;
+}
+
+static void
+_rb_null_timer_end(render_backend_t* backend, unsigned int timer) {
+	FOUNDATION_UNUSED(backend);
+	FOUNDATION_UNUSED(timer);
+}
+
+static bool
+_rb_null_timer_result(render_backend_t* backend, unsigned int timer, uint64_t* nanoseconds) {
+	FOUNDATION_UNUSED(backend);
+	FOUNDATION_UNUSED(timer);
+	FOUNDATION_UNUSED(nanoseconds);
+	return false;
+}
+
 static void
 _rb_null_enable_thread(render_backend_t* backend) {
 	FOUNDATION_UNUSED(backend);
@@ -224,7 +248,10 @@ static render_backend_vtable_t _render_backend_vtable_null = {
     .deallocate_texture = _rb_null_deallocate_texture,
     .allocate_target = _rb_null_allocate_target,
     .resize_target = _rb_null_resize_target,
-    .deallocate_target = _rb_null_deallocate_target};
+    .deallocate_target = _rb_null_deallocate_target,
+    .timer_begin = _rb_null_timer_begin,
+    .timer_end = _rb_null_timer_end,
+    .timer_result = _rb_null_timer_result};
 
 render_backend_t*
 render_backend_null_allocate(void) {
@@ -0,0 +1,103 @@
+/* palette.c  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+
+#include <render/render.h>
+#include <render/internal.h>
+
+#include <vector/matrix.h>
+
+#define RENDER_PALETTE_MATRIX_SIZE (sizeof(float32_t) * 16)
+
+render_palettebuffer_t*
+render_palettebuffer_allocate(render_backend_t* backend, render_usage_t usage,
+                              size_t num_matrices) {
+	render_palettebuffer_t* buffer =
+	    render_pool_allocate(&_render_buffer_pool, sizeof(render_palettebuffer_t));
+	buffer->backend = backend;
+	buffer->usage = (uint8_t)usage;
+	buffer->buffertype = RENDERBUFFER_PALETTE;
+	buffer->policy = RENDERBUFFER_UPLOAD_ONDISPATCH;
+	buffer->buffersize = num_matrices * RENDER_PALETTE_MATRIX_SIZE;
+	semaphore_initialize(&buffer->lock, 1);
+	memset(buffer->backend_data, 0, sizeof(buffer->backend_data));
+	atomic_store32(&buffer->reserved, 0, memory_order_release);
+
+	if (num_matrices) {
+		buffer->allocated = num_matrices;
+		buffer->store = backend->vtable.allocate_buffer(backend, (render_buffer_t*)buffer);
+	}
+
+	return buffer;
+}
+
+void
+render_palettebuffer_deallocate(render_palettebuffer_t* buffer) {
+	render_buffer_deallocate((render_buffer_t*)buffer);
+}
+
+void
+render_palettebuffer_lock(render_palettebuffer_t* buffer, unsigned int lock) {
+	render_buffer_lock((render_buffer_t*)buffer, lock);
+}
+
+void
+render_palettebuffer_unlock(render_palettebuffer_t* buffer) {
+	int32_t reserved = atomic_load32(&buffer->reserved, memory_order_acquire);
+	buffer->used = ((size_t)reserved < buffer->allocated) ? (size_t)reserved : buffer->allocated;
+	render_buffer_unlock((render_buffer_t*)buffer);
+}
+
+void
+render_palettebuffer_upload(render_palettebuffer_t* buffer) {
+	render_buffer_upload((render_buffer_t*)buffer);
+}
+
+void
+render_palettebuffer_free(render_palettebuffer_t* buffer, bool sys, bool aux) {
+	render_buffer_free((render_buffer_t*)buffer, sys, aux);
+}
+
+void
+render_palettebuffer_restore(render_palettebuffer_t* buffer) {
+	render_buffer_restore((render_buffer_t*)buffer);
+}
+
+void
+render_palettebuffer_reset(render_palettebuffer_t* buffer) {
+	atomic_store32(&buffer->reserved, 0, memory_order_release);
+	buffer->used = 0;
+}
+
+unsigned int
+render_palettebuffer_append(render_palettebuffer_t* buffer, const matrix_t* bones, size_t count) {
+	FOUNDATION_ASSERT_MSG(buffer->access, "Palette buffer must be locked for write when appending");
+	size_t offset = (size_t)atomic_exchange_and_add32(&buffer->reserved, (int32_t)count,
+	                                                  memory_order_relaxed);
+	if (offset + count > buffer->allocated) {
+		log_warn(HASH_RENDER, WARNING_RESOURCE, STRING_CONST("Palette buffer full"));
+		return RENDER_PALETTE_INVALID_OFFSET;
+	}
+
+	float32_t* out = pointer_offset(buffer->access, offset * RENDER_PALETTE_MATRIX_SIZE);
+	for (size_t ibone = 0; ibone < count; ++ibone, out += 16)
+		render_transform_store(out, bones + ibone);
+
+	return (unsigned int)offset;
+}
@@ -0,0 +1,84 @@
+/* palette.h  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file palette.h
+    Matrix palette buffer for skinning. Bone matrices for all skinned objects are packed
+    into one palette buffer per frame, and each render command references the palette
+    buffer with an offset to the first bone of the object.
+
+    Matrices are stored in column major layout, 16 floats per matrix. Programs access the
+    palette through a parameter named "palette":
+    - GL4 declares it as a samplerBuffer of four RGBA32F texels per matrix (one per column)
+      together with an int uniform named "palette_offset" receiving the offset of the
+      render command, i.e. texelFetch(palette, (palette_offset + bone) * 4 + column)
+    - GL2 declares it as a mat4 uniform array, which receives the matrices starting at
+      the offset of the render command
+
+    Bone indices should use a non-normalized vertex format like VERTEXFORMAT_SHORT4 with
+    VERTEXATTRIBUTE_INDEX, and weights VERTEXATTRIBUTE_WEIGHT */
+
+#include <foundation/platform.h>
+
+#include <render/types.h>
+
+#define RENDER_PALETTE_INVALID_OFFSET 0xFFFFFFFFU
+
+/*! Allocate a palette buffer
+\param backend Backend
+\param usage Buffer usage, normally RENDERUSAGE_DYNAMIC when repacked every frame
+\param num_matrices Capacity in number of matrices
+\return Palette buffer */
+RENDER_API render_palettebuffer_t*
+render_palettebuffer_allocate(render_backend_t* backend, render_usage_t usage,
+                              size_t num_matrices);
+
+RENDER_API void
+render_palettebuffer_deallocate(render_palettebuffer_t* buffer);
+
+RENDER_API void
+render_palettebuffer_lock(render_palettebuffer_t* buffer, unsigned int lock);
+
+RENDER_API void
+render_palettebuffer_unlock(render_palettebuffer_t* buffer);
+
+RENDER_API void
+render_palettebuffer_upload(render_palettebuffer_t* buffer);
+
+RENDER_API void
+render_palettebuffer_free(render_palettebuffer_t* buffer, bool sys, bool aux);
+
+RENDER_API void
+render_palettebuffer_restore(render_palettebuffer_t* buffer);
+
+/*! Reset the palette buffer to start packing a new frame. Must not be called while
+appending or while the buffer is referenced by a dispatch in progress
+\param buffer Palette buffer */
+RENDER_API void
+render_palettebuffer_reset(render_palettebuffer_t* buffer);
+
+/*! Append bone matrices to the palette buffer. The buffer must be locked for writing,
+appends from multiple threads are allowed and reserve disjoint ranges
+\param buffer Palette buffer
+\param bones Row major bone matrices
+\param count Number of matrices
+\return Offset in matrices to pass to render_command_set_palette, or
+        RENDER_PALETTE_INVALID_OFFSET if the buffer is full */
+RENDER_API unsigned int
+render_palettebuffer_append(render_palettebuffer_t* buffer, const matrix_t* bones, size_t count);
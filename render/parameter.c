@@ -30,7 +30,11 @@ render_parameterbuffer_initialize(render_parameterbuffer_t* parameterbuffer,
 	parameterbuffer->usage = (uint8_t)usage;
 	parameterbuffer->buffertype = RENDERBUFFER_PARAMETER;
 	parameterbuffer->policy = RENDERBUFFER_UPLOAD_ONDISPATCH;
+	parameterbuffer->flags = 0;
+	parameterbuffer->locks = 0;
 	parameterbuffer->buffersize = data_size;
+	parameterbuffer->backing = nullptr;
+	parameterbuffer->generation = render_buffer_generation();
 	parameterbuffer->parameter_count = (unsigned int)parameter_count;
 	semaphore_initialize(&parameterbuffer->lock, 1);
 	if (parameters) {
@@ -53,10 +57,9 @@ render_parameterbuffer_t*
 render_parameterbuffer_allocate(render_backend_t* backend, render_usage_t usage,
                                 const render_parameter_t* parameters, size_t parameter_count,
                                 const void* data, size_t data_size) {
-	render_parameterbuffer_t* parameterbuffer = memory_allocate(
-	    HASH_RENDER,
-	    sizeof(render_parameterbuffer_t) + (sizeof(render_parameter_t) * parameter_count), 0,
-	    MEMORY_PERSISTENT);
+	render_parameterbuffer_t* parameterbuffer = render_pool_allocate(
+	    &_render_buffer_pool,
+	    sizeof(render_parameterbuffer_t) + (sizeof(render_parameter_t) * parameter_count));
 	render_parameterbuffer_initialize(parameterbuffer, backend, usage, parameters, parameter_count,
 	                                  data, data_size);
 	return parameterbuffer;
@@ -89,17 +92,10 @@ render_parameterbuffer_upload(render_parameterbuffer_t* buffer) {
 
 void
 render_parameterbuffer_free(render_parameterbuffer_t* buffer, bool sys, bool aux) {
-	buffer->backend->vtable.deallocate_buffer(buffer->backend, (render_buffer_t*)buffer, sys, aux);
+	render_buffer_free((render_buffer_t*)buffer, sys, aux);
 }
 
 void
 render_parameterbuffer_restore(render_parameterbuffer_t* buffer) {
-	buffer->backend->vtable.allocate_buffer(buffer->backend, (render_buffer_t*)buffer);
-
-	//...
-	// All loadable resources should have a stream identifier, an offset and a size
-	// to be able to repoen the stream and read the raw buffer back
-	//...
-
-	buffer->flags |= RENDERBUFFER_DIRTY;
+	render_buffer_restore((render_buffer_t*)buffer);
 }
@@ -18,14 +18,23 @@
 
 #include <render/pipeline.h>
 #include <render/context.h>
+#include <render/command.h>
+#include <render/target.h>
+#include <render/trace.h>
 #include <render/sort.h>
 #include <render/backend.h>
+#include <render/state.h>
+#include <render/pool.h>
 #include <render/hashstrings.h>
+#include <render/internal.h>
 
 #include <foundation/memory.h>
 #include <foundation/array.h>
 #include <foundation/atomic.h>
-#include <foundation/thread.h>
+#include <foundation/semaphore.h>
+#include <foundation/radixsort.h>
+#include <foundation/log.h>
+#include <foundation/time.h>
 
 #include <task/scheduler.h>
 
@@ -41,6 +50,46 @@ void
 render_pipeline_initialize(render_pipeline_t* pipeline, render_backend_t* backend) {
 	memset(pipeline, 0, sizeof(render_pipeline_t));
 	pipeline->backend = backend;
+	semaphore_initialize(&pipeline->recorded, 0);
+}
+
+static void
+render_pipeline_collect_timer(render_backend_t* backend, unsigned int* timer, uint64_t* time) {
+	if (*timer && render_backend_timer_result(backend, *timer, time))
+		*timer = 0;
+}
+
+static void
+render_pipeline_release_timer(render_backend_t* backend, unsigned int* timer) {
+	if (*timer)
+		render_backend_timer_result(backend, *timer, nullptr);
+	*timer = 0;
+}
+
+static void
+render_pipeline_release_timers(render_pipeline_t* pipeline) {
+	for (size_t iframe = 0; iframe < RENDER_PIPELINE_STATISTICS_FRAMES; ++iframe) {
+		render_pipeline_release_timer(pipeline->backend, &pipeline->statistics[iframe].gpu_timer);
+		for (size_t istep = 0, ssize = array_size(pipeline->steps); istep < ssize; ++istep)
+			render_pipeline_release_timer(pipeline->backend,
+			                              &pipeline->steps[istep].statistics[iframe].gpu_timer);
+	}
+}
+
+static void
+render_pipeline_collect_timers(render_pipeline_t* pipeline) {
+	// GPU results of earlier frames are collected as they become available, never waited for
+	for (size_t iframe = 0; iframe < RENDER_PIPELINE_STATISTICS_FRAMES; ++iframe) {
+		render_pipeline_statistics_t* statistics = pipeline->statistics + iframe;
+		render_pipeline_collect_timer(pipeline->backend, &statistics->gpu_timer,
+		                              &statistics->gpu_time);
+		for (size_t istep = 0, ssize = array_size(pipeline->steps); istep < ssize; ++istep) {
+			render_pipeline_step_statistics_t* step_statistics =
+			    pipeline->steps[istep].statistics + iframe;
+			render_pipeline_collect_timer(pipeline->backend, &step_statistics->gpu_timer,
+			                              &step_statistics->gpu_time);
+		}
+	}
 }
 
 void
@@ -48,9 +97,20 @@ render_pipeline_finalize(render_pipeline_t* pipeline) {
 	if (pipeline) {
 		array_deallocate(pipeline->step_task);
 		array_deallocate(pipeline->step_arg);
+		render_pipeline_release_timers(pipeline);
 		for (size_t istep = 0, ssize = array_size(pipeline->steps); istep < ssize; ++istep)
 			render_pipeline_step_finalize(pipeline->steps + istep);
 		array_deallocate(pipeline->steps);
+		array_deallocate(pipeline->outputs);
+		array_deallocate(pipeline->order);
+		for (size_t istorage = 0, ssize = array_size(pipeline->storage); istorage < ssize;
+		     ++istorage)
+			render_pipeline_release_storage(pipeline, pipeline->storage[istorage].target);
+		array_deallocate(pipeline->storage);
+		for (size_t itrans = 0, tsize = array_size(pipeline->transients); itrans < tsize; ++itrans)
+			memory_deallocate(pipeline->transients[itrans]);
+		array_deallocate(pipeline->transients);
+		semaphore_finalize(&pipeline->recorded);
 	}
 }
 
@@ -60,63 +120,720 @@ render_pipeline_deallocate(render_pipeline_t* pipeline) {
 	memory_deallocate(pipeline);
 }
 
-static task_return_t
-render_pipeline_execute_step(task_arg_t arg) {
-	render_pipeline_step_t* step = arg;
+enum {
+	RENDER_PIPELINE_STEP_PENDING = 0,
+	RENDER_PIPELINE_STEP_RECORDED
+};
 
+static unsigned int
+render_pipeline_step_partitions(const render_pipeline_step_t* step) {
+	// Each partition records to its own context
 	size_t context_count = array_size(step->contexts);
-	step->executor(step->backend, step->target, step->contexts, context_count);
+	if (!step->partition_executor || (step->partitions < 2) || (context_count < 2))
+		return 1;
+	return (step->partitions < context_count) ? step->partitions : (unsigned int)context_count;
+}
 
-	render_sort_merge(step->contexts, context_count);
+static void
+render_pipeline_queue_step(render_pipeline_t* pipeline, size_t istep) {
+	render_pipeline_step_t* step = pipeline->steps + istep;
+	task_scheduler_multiqueue(pipeline->scheduler, render_pipeline_step_partitions(step),
+	                          pipeline->step_task + step->task_offset,
+	                          pipeline->step_arg + step->task_offset, 0);
+}
+
+static void
+render_pipeline_blit(render_pipeline_step_t* step) {
+	if (!array_size(step->contexts))
+		array_push(step->contexts, render_context_allocate(1));
+	render_command_t* command = render_context_reserve(step->contexts[0], 0);
+	// A scaled source only holds an image in the scaled resolution rectangle
+	const render_scaling_t* scaling = step->blit_scaling;
+	render_command_blit(command, step->blit_source, 0, 0, scaling ? scaling->width : 0,
+	                    scaling ? scaling->height : 0, 0, 0, 0, 0, RENDERBUFFER_COLOR);
+}
+
+static void
+render_pipeline_finish_step(render_pipeline_step_t* step, bool signal) {
+	tick_t sort_start = time_current();
+	render_sort_merge(step->contexts, array_size(step->contexts));
+	step->sort_time = time_diff(sort_start, time_current());
+
+	// Queue dependent steps once all their dependencies are recorded
+	render_pipeline_t* pipeline = step->pipeline;
+	if (pipeline && pipeline->scheduler) {
+		for (size_t idep = 0, dsize = array_size(step->dependents); idep < dsize; ++idep) {
+			size_t dependent = step->dependents[idep];
+			if (!pipeline->steps[dependent].culled &&
+			    !atomic_decr32(&pipeline->steps[dependent].pending, memory_order_acq_rel))
+				render_pipeline_queue_step(pipeline, dependent);
+		}
+	}
 
 	if (step->task_counter)
 		atomic_incr32(step->task_counter, memory_order_release);
 
+	atomic_store32(&step->record_state, RENDER_PIPELINE_STEP_RECORDED, memory_order_release);
+	if (signal)
+		semaphore_post(&pipeline->recorded);
+}
+
+static bool
+render_pipeline_record_partition(render_pipeline_step_t* step, bool signal) {
+	unsigned int partitions = render_pipeline_step_partitions(step);
+	if (atomic_load32(&step->partition_next, memory_order_relaxed) >= (int32_t)partitions)
+		return false;
+	int32_t partition = atomic_exchange_and_add32(&step->partition_next, 1, memory_order_acq_rel);
+	if (partition >= (int32_t)partitions)
+		return false;
+
+	tick_t executor_start = time_current();
+	tick_t trace = render_trace_begin();
+	// A step without contexts has nothing to record partitions to, use the step executor
+	if (step->partition_executor && array_size(step->contexts)) {
+		size_t work = step->partition_work;
+		size_t begin = (work * (size_t)partition) / partitions;
+		size_t end = (work * (size_t)(partition + 1)) / partitions;
+		step->partition_executor(step->backend, step->target, step->contexts[partition], begin,
+		                         end);
+	} else {
+		if (step->blit_source)
+			render_pipeline_blit(step);
+		if (step->executor)
+			step->executor(step->backend, step->target, step->contexts,
+			               array_size(step->contexts));
+	}
+	render_trace_end(trace, STRING_CONST("render_pipeline_record"));
+	atomic_add64(&step->executor_time, (int64_t)time_diff(executor_start, time_current()),
+	             memory_order_relaxed);
+
+	// Last partition to finish merges the contexts and completes the step
+	if (!atomic_decr32(&step->partition_pending, memory_order_acq_rel))
+		render_pipeline_finish_step(step, signal);
+	return true;
+}
+
+static task_return_t
+render_pipeline_execute_step(task_arg_t arg) {
+	render_pipeline_step_t* step = arg;
+	// Partitions may already have been recorded by other tasks of the step or by the
+	// dispatching thread while waiting
+	while (render_pipeline_record_partition(step, true)) {
+	}
 	return (task_return_t){TASK_FINISH, 0};
 }
 
+static bool
+render_pipeline_order_contains(const size_t* indices, size_t index) {
+	for (size_t iindex = 0, isize = array_size(indices); iindex < isize; ++iindex) {
+		if (indices[iindex] == index)
+			return true;
+	}
+	return false;
+}
+
+static bool
+render_pipeline_target_in(render_target_t* const* targets, const render_target_t* target) {
+	for (size_t itarget = 0, tsize = array_size(targets); itarget < tsize; ++itarget) {
+		if (targets[itarget] == target)
+			return true;
+	}
+	return false;
+}
+
+static bool
+render_pipeline_step_depends(const render_pipeline_step_t* step, size_t index,
+                             const render_pipeline_step_t* other, size_t other_index) {
+	for (size_t iwrite = 0, wsize = array_size(other->writes); iwrite < wsize; ++iwrite) {
+		render_target_t* target = other->writes[iwrite];
+		// Readers of a target depend on all its writers, writers of the same target
+		// keep the order they were added to the pipeline in
+		if (render_pipeline_target_in(step->reads, target) ||
+		    ((other_index < index) && render_pipeline_target_in(step->writes, target)))
+			return true;
+	}
+	return false;
+}
+
+static void
+render_pipeline_build(render_pipeline_t* pipeline) {
+	size_t step_count = array_size(pipeline->steps);
+	for (size_t istep = 0; istep < step_count; ++istep) {
+		render_pipeline_step_t* step = pipeline->steps + istep;
+		array_clear(step->dependents);
+		step->dependencies = 0;
+		step->culled = false;
+	}
+
+	for (size_t istep = 0; istep < step_count; ++istep) {
+		render_pipeline_step_t* step = pipeline->steps + istep;
+		for (size_t iother = 0; iother < step_count; ++iother) {
+			if ((iother != istep) &&
+			    render_pipeline_step_depends(step, istep, pipeline->steps + iother, iother)) {
+				array_push(pipeline->steps[iother].dependents, istep);
+				++step->dependencies;
+			}
+		}
+	}
+
+	// Without declared outputs every step is assumed to have results used outside
+	// the pipeline. Otherwise only steps contributing to an output or the frame buffer
+	// are kept, propagated backwards from the outputs until no step changes state
+	if (array_size(pipeline->outputs)) {
+		render_target_t* framebuffer = render_backend_target_framebuffer(pipeline->backend);
+		for (size_t istep = 0; istep < step_count; ++istep) {
+			render_pipeline_step_t* step = pipeline->steps + istep;
+			step->culled = !render_pipeline_target_in(step->writes, framebuffer);
+			for (size_t iwrite = 0, wsize = array_size(step->writes); step->culled && (iwrite < wsize);
+			     ++iwrite)
+				step->culled = !render_pipeline_target_in(pipeline->outputs, step->writes[iwrite]);
+		}
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			for (size_t istep = 0; istep < step_count; ++istep) {
+				render_pipeline_step_t* step = pipeline->steps + istep;
+				for (size_t idep = 0, dsize = array_size(step->dependents);
+				     step->culled && (idep < dsize); ++idep) {
+					if (!pipeline->steps[step->dependents[idep]].culled) {
+						step->culled = false;
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+
+	// Topological order, picking the first ready step in pipeline order so independent
+	// steps keep the order they were added in
+	array_clear(pipeline->order);
+	for (size_t istep = 0; istep < step_count; ++istep)
+		atomic_store32(&pipeline->steps[istep].pending, (int32_t)pipeline->steps[istep].dependencies,
+		               memory_order_relaxed);
+	size_t live_count = 0;
+	for (size_t istep = 0; istep < step_count; ++istep)
+		live_count += pipeline->steps[istep].culled ? 0 : 1;
+	while (array_size(pipeline->order) < live_count) {
+		size_t ready = step_count;
+		for (size_t istep = 0; istep < step_count; ++istep) {
+			render_pipeline_step_t* step = pipeline->steps + istep;
+			if (!step->culled && !atomic_load32(&step->pending, memory_order_relaxed) &&
+			    !render_pipeline_order_contains(pipeline->order, istep)) {
+				ready = istep;
+				break;
+			}
+		}
+		if (ready == step_count) {
+			log_warn(HASH_RENDER, WARNING_INVALID_VALUE,
+			         STRING_CONST("Render pipeline has cyclic step dependencies, using step order"));
+			array_clear(pipeline->order);
+			for (size_t istep = 0; istep < step_count; ++istep) {
+				array_clear(pipeline->steps[istep].dependents);
+				pipeline->steps[istep].dependencies = 0;
+				if (!pipeline->steps[istep].culled)
+					array_push(pipeline->order, istep);
+			}
+			break;
+		}
+		array_push(pipeline->order, ready);
+		render_pipeline_step_t* step = pipeline->steps + ready;
+		for (size_t idep = 0, dsize = array_size(step->dependents); idep < dsize; ++idep)
+			atomic_decr32(&pipeline->steps[step->dependents[idep]].pending, memory_order_relaxed);
+	}
+
+	for (size_t istep = 0; istep < step_count; ++istep) {
+		render_pipeline_step_t* step = pipeline->steps + istep;
+		// Only dependencies on steps that are recorded can block recording
+		unsigned int pending = 0;
+		for (size_t iother = 0; iother < step_count; ++iother) {
+			if (!pipeline->steps[iother].culled &&
+			    render_pipeline_order_contains(pipeline->steps[iother].dependents, istep))
+				++pending;
+		}
+		step->dependencies = pending;
+		atomic_store32(&step->pending, (int32_t)pending, memory_order_relaxed);
+	}
+}
+
+static void
+render_pipeline_release_storage(render_pipeline_t* pipeline, render_target_t* target) {
+	// Commands of frames not yet flipped can reference the storage, destroy it at a later flip
+	render_backend_queue_destroy(pipeline->backend, &target->destroy, RENDERDESTROY_TARGET,
+	                             target);
+}
+
+static bool
+render_pipeline_storage_matches(const render_target_t* storage, const render_target_t* target) {
+	return (storage->width == target->width) && (storage->height == target->height) &&
+	       (storage->pixelformat == target->pixelformat) &&
+	       (storage->colorspace == target->colorspace);
+}
+
+static void
+render_pipeline_assign_transients(render_pipeline_t* pipeline) {
+	size_t transient_count = array_size(pipeline->transients);
+	size_t order_count = array_size(pipeline->order);
+	if (!transient_count)
+		return;
+
+	// Lifetime of a transient target spans the dispatch positions of the steps using it.
+	// Outputs are used after the pipeline and live to the end
+	for (size_t itrans = 0; itrans < transient_count; ++itrans) {
+		render_pipeline_transient_t* transient = pipeline->transients[itrans];
+		render_target_t* target = &transient->target;
+		transient->storage = 0;
+		transient->first = order_count;
+		transient->last = 0;
+		for (size_t iorder = 0; iorder < order_count; ++iorder) {
+			const render_pipeline_step_t* step = pipeline->steps + pipeline->order[iorder];
+			if (render_pipeline_target_in(step->reads, target) ||
+			    render_pipeline_target_in(step->writes, target)) {
+				if (transient->first == order_count)
+					transient->first = iorder;
+				transient->last = iorder;
+			}
+		}
+		if ((transient->first < order_count) &&
+		    render_pipeline_target_in(pipeline->outputs, target))
+			transient->last = order_count;
+	}
+
+	for (size_t istorage = 0, ssize = array_size(pipeline->storage); istorage < ssize; ++istorage)
+		pipeline->storage[istorage].users = 0;
+
+	// Assign in order of first use, reusing a pooled target of the same size and format
+	// once all steps using it for previous transient targets are dispatched
+	for (size_t iorder = 0; iorder < order_count; ++iorder) {
+		for (size_t itrans = 0; itrans < transient_count; ++itrans) {
+			render_pipeline_transient_t* transient = pipeline->transients[itrans];
+			if (transient->first != iorder)
+				continue;
+			render_target_t* target = &transient->target;
+			size_t istorage = 0;
+			size_t ssize = array_size(pipeline->storage);
+			for (; istorage < ssize; ++istorage) {
+				render_pipeline_storage_t* storage = pipeline->storage + istorage;
+				if (render_pipeline_storage_matches(storage->target, target) &&
+				    (!storage->users || (storage->last < transient->first)))
+					break;
+			}
+			if (istorage == ssize) {
+				FOUNDATION_ASSERT_MSG(render_backend_thread() == pipeline->backend,
+				                      "Transient storage allocated off the dispatching thread");
+				render_pipeline_storage_t storage;
+				storage.target = render_target_allocate(pipeline->backend, target->width,
+				                                        target->height, target->pixelformat,
+				                                        target->colorspace);
+				storage.last = 0;
+				storage.users = 0;
+				if (!storage.target->backend) {
+					log_warn(HASH_RENDER, WARNING_INVALID_VALUE,
+					         STRING_CONST("Unable to allocate transient render target storage"));
+					render_target_deallocate(storage.target);
+					continue;
+				}
+				array_push(pipeline->storage, storage);
+			}
+			pipeline->storage[istorage].last = transient->last;
+			++pipeline->storage[istorage].users;
+			transient->storage = istorage + 1;
+		}
+	}
+
+	// Release pooled targets not used this frame, for example after a resolution change
+	for (size_t istorage = array_size(pipeline->storage); istorage > 0; --istorage) {
+		if (pipeline->storage[istorage - 1].users)
+			continue;
+		render_pipeline_release_storage(pipeline, pipeline->storage[istorage - 1].target);
+		array_erase_ordered(pipeline->storage, istorage - 1);
+		for (size_t itrans = 0; itrans < transient_count; ++itrans) {
+			if (pipeline->transients[itrans]->storage > istorage)
+				--pipeline->transients[itrans]->storage;
+		}
+	}
+
+	for (size_t itrans = 0; itrans < transient_count; ++itrans) {
+		render_pipeline_transient_t* transient = pipeline->transients[itrans];
+		render_target_t* target = &transient->target;
+		if (!transient->storage) {
+			target->backend = nullptr;
+			memset(target->backend_data, 0, sizeof(target->backend_data));
+			continue;
+		}
+		render_target_t* storage = pipeline->storage[transient->storage - 1].target;
+		// Shared storage holds the content of another target when next used, and moved
+		// storage does not hold the content dispatched last frame, so neither is idle
+		if ((pipeline->storage[transient->storage - 1].users > 1) ||
+		    (target->backend_data[0] != storage->backend_data[0]))
+			target->dispatch_hash = 0;
+		target->backend = storage->backend;
+		memcpy(target->backend_data, storage->backend_data, sizeof(target->backend_data));
+	}
+}
+
 void
 render_pipeline_execute(render_pipeline_t* pipeline) {
+	pipeline->frame_start = time_current();
+	render_pipeline_build(pipeline);
+	render_pipeline_assign_transients(pipeline);
+
+	size_t step_count = array_size(pipeline->steps);
+	size_t order_count = array_size(pipeline->order);
+	size_t task_count = 0;
+	for (size_t istep = 0; istep < step_count; ++istep) {
+		render_pipeline_step_t* step = pipeline->steps + istep;
+		unsigned int partitions = render_pipeline_step_partitions(step);
+		step->backend = pipeline->backend;
+		step->pipeline = pipeline;
+		step->task_counter = pipeline->scheduler ? &pipeline->step_complete : nullptr;
+		step->task_offset = task_count;
+		task_count += partitions;
+		atomic_store32(&step->partition_next, 0, memory_order_relaxed);
+		atomic_store32(&step->partition_pending, (int32_t)partitions, memory_order_relaxed);
+		atomic_store64(&step->executor_time, 0, memory_order_relaxed);
+		step->sort_time = 0;
+		atomic_store32(&step->record_state, RENDER_PIPELINE_STEP_PENDING, memory_order_release);
+	}
+
 	if (pipeline->scheduler) {
-		size_t step_count = array_size(pipeline->steps);
-		array_resize(pipeline->step_task, step_count);
-		array_resize(pipeline->step_arg, step_count);
+		array_resize(pipeline->step_task, task_count);
+		array_resize(pipeline->step_arg, task_count);
 		atomic_store32(&pipeline->step_complete, 0, memory_order_release);
+		// Drop signals of steps recorded by tasks the previous frame never waited for
+		while (semaphore_try_wait(&pipeline->recorded, 0)) {
+		}
+		// One task per partition, each recording partitions until all are claimed
 		for (size_t istep = 0; istep < step_count; ++istep) {
 			render_pipeline_step_t* step = pipeline->steps + istep;
-			step->backend = pipeline->backend;
-			step->task_counter = &pipeline->step_complete;
-
-			pipeline->step_task[istep].function = render_pipeline_execute_step;
-			pipeline->step_task[istep].name =
-			    string_const(STRING_CONST("render_pipeline_execute_step"));
-			pipeline->step_arg[istep] = step;
+			size_t task_end = (istep + 1 < step_count) ? step[1].task_offset : task_count;
+			for (size_t itask = step->task_offset; itask < task_end; ++itask) {
+				pipeline->step_task[itask].function = render_pipeline_execute_step;
+				pipeline->step_task[itask].name =
+				    string_const(STRING_CONST("render_pipeline_execute_step"));
+				pipeline->step_arg[itask] = step;
+			}
+		}
+		// Steps without dependencies are queued here, the others are queued by the last
+		// of their dependencies to finish
+		for (size_t iorder = 0; iorder < order_count; ++iorder) {
+			size_t istep = pipeline->order[iorder];
+			if (!pipeline->steps[istep].dependencies)
+				render_pipeline_queue_step(pipeline, istep);
 		}
-		task_scheduler_multiqueue(pipeline->scheduler, step_count, pipeline->step_task,
-		                          pipeline->step_arg, 0);
 	} else {
-		for (size_t istep = 0, ssize = array_size(pipeline->steps); istep < ssize; ++istep) {
-			render_pipeline_step_t* step = pipeline->steps + istep;
-			step->backend = pipeline->backend;
-			step->task_counter = nullptr;
-			render_pipeline_execute_step(step);
+		for (size_t iorder = 0; iorder < order_count; ++iorder) {
+			render_pipeline_step_t* step = pipeline->steps + pipeline->order[iorder];
+			while (render_pipeline_record_partition(step, false)) {
+			}
 		}
 	}
 }
 
-void
+static bool
+render_pipeline_depth_opaque(const render_command_t* command) {
+	// Commands without a state buffer use the default state, which is opaque
+	const render_statebuffer_t* statebuffer = command->data.render.statebuffer;
+	return !statebuffer || (!statebuffer->state.blend_enable[0] && statebuffer->state.depth_write);
+}
+
+static render_pipeline_depth_state_t*
+render_pipeline_depth_state(render_pipeline_step_t* step, render_backend_t* backend,
+                            render_statebuffer_t* source) {
+	render_state_t state = source ? source->state : render_state_default();
+	render_pipeline_depth_state_t* entry = nullptr;
+	for (size_t ientry = 0, esize = array_size(step->depth_state); ientry < esize; ++ientry) {
+		if (step->depth_state[ientry].source == source) {
+			entry = step->depth_state + ientry;
+			if (!memcmp(&entry->state, &state, sizeof(render_state_t)))
+				return entry;
+			break;
+		}
+	}
+	if (!entry) {
+		render_pipeline_depth_state_t new_entry;
+		new_entry.source = source;
+		new_entry.depth = render_statebuffer_allocate(backend, RENDERUSAGE_DYNAMIC, state);
+		new_entry.equal = render_statebuffer_allocate(backend, RENDERUSAGE_DYNAMIC, state);
+		array_push(step->depth_state, new_entry);
+		entry = step->depth_state + (array_size(step->depth_state) - 1);
+	}
+
+	// Derived buffers are only referenced by commands of the dispatch in progress,
+	// so the state is written directly without locking
+	entry->state = state;
+	render_state_t* depth = &entry->depth->state;
+	*depth = state;
+	memset(depth->blend_enable, 0, sizeof(depth->blend_enable));
+	memset(depth->target_write, 0, sizeof(depth->target_write));
+	render_state_t* equal = &entry->equal->state;
+	*equal = state;
+	equal->depth_func = RENDER_CMP_EQUAL;
+	equal->depth_write = false;
+	return entry;
+}
+
+static uint64_t
+render_pipeline_depth_key(float32_t depth) {
+	// Bit pattern of non-negative floats orders the same as their value
+	union {
+		float32_t depth;
+		uint32_t bits;
+	} value;
+	value.depth = (depth > 0) ? depth : 0;
+	return value.bits;
+}
+
+static void
+render_pipeline_depth_prepass(render_pipeline_t* pipeline, render_pipeline_step_t* step) {
+	render_pipeline_step_t* source = pipeline->steps + (step->depth_source - 1);
+	size_t source_count = array_size(source->contexts);
+
+	size_t capacity = 0;
+	for (size_t icontext = 0; icontext < source_count; ++icontext)
+		capacity += render_context_reserved(source->contexts[icontext]);
+	if (!capacity)
+		return;
+
+	render_context_t* context = array_size(step->contexts) ? step->contexts[0] : nullptr;
+	if (!context || ((size_t)context->allocated < capacity)) {
+		render_context_deallocate(context);
+		context = render_context_allocate(capacity + (capacity / 2));
+		if (array_size(step->contexts))
+			step->contexts[0] = context;
+		else
+			array_push(step->contexts, context);
+	}
+
+	// Clear and viewport commands split the pass in segments, draws are sorted front to
+	// back within their segment. Depth and stencil clears move to the pre-pass
+	uint64_t segment = 0;
+	for (size_t icontext = 0; icontext < source_count; ++icontext) {
+		render_context_t* source_context = source->contexts[icontext];
+		size_t cmd_size = render_context_reserved(source_context);
+		for (size_t iorder = 0; iorder < cmd_size; ++iorder) {
+			size_t index = (source_context->sort->indextype == RADIXSORT_INDEX16) ?
+			                   ((const uint16_t*)source_context->order)[iorder] :
+			                   ((const uint32_t*)source_context->order)[iorder];
+			render_command_t* command = source_context->commands + index;
+			if (command->type == RENDERCOMMAND_VIEWPORT) {
+				++segment;
+				render_context_queue(context, command, segment << 33ULL);
+			} else if (command->type == RENDERCOMMAND_CLEAR) {
+				unsigned int depth_mask =
+				    command->data.clear.buffer_mask & (RENDERBUFFER_DEPTH | RENDERBUFFER_STENCIL);
+				++segment;
+				if (depth_mask) {
+					render_command_t* derived = render_context_reserve(context, segment << 33ULL);
+					*derived = *command;
+					derived->data.clear.buffer_mask = depth_mask;
+					command->data.clear.buffer_mask &= ~depth_mask;
+					if (!command->data.clear.buffer_mask)
+						command->type = RENDERCOMMAND_INVALID;
+				}
+			} else if ((command->type >= RENDERCOMMAND_RENDER_TRIANGLELIST) &&
+			           render_pipeline_depth_opaque(command)) {
+				render_program_t* program = step->depth_program(command->data.render.program);
+				if (!program)
+					continue;
+				render_pipeline_depth_state_t* state = render_pipeline_depth_state(
+				    step, pipeline->backend, command->data.render.statebuffer);
+
+				render_command_t* derived = render_context_reserve(
+				    context, (segment << 33ULL) | (1ULL << 32ULL) |
+				                 render_pipeline_depth_key(command->data.render.depth));
+				*derived = *command;
+				derived->data.render.program = program;
+				derived->data.render.program_handle = render_program_handle(program);
+				derived->data.render.statebuffer = state->depth;
+				derived->data.render.statebuffer_handle = render_buffer_handle(state->depth);
+
+				command->data.render.statebuffer = state->equal;
+				command->data.render.statebuffer_handle = render_buffer_handle(state->equal);
+			}
+		}
+	}
+
+	render_sort_merge(step->contexts, 1);
+}
+
+static bool
+render_pipeline_help(render_pipeline_t* pipeline, size_t first) {
+	// Record a partition of a ready step in dispatch order, starting with the step waited for
+	for (size_t iorder = first, order_count = array_size(pipeline->order); iorder < order_count;
+	     ++iorder) {
+		render_pipeline_step_t* step = pipeline->steps + pipeline->order[iorder];
+		if (!atomic_load32(&step->pending, memory_order_acquire) &&
+		    render_pipeline_record_partition(step, false))
+			return true;
+	}
+	return false;
+}
+
+static void
+render_pipeline_wait_recorded(render_pipeline_t* pipeline, render_pipeline_step_t* step,
+                              size_t first, render_pipeline_statistics_t* frame_statistics) {
+	// Help with recording while waiting, blocking until a scheduler task finishes a step
+	// if no step is ready
+	while (atomic_load32(&step->record_state, memory_order_acquire) !=
+	       RENDER_PIPELINE_STEP_RECORDED) {
+		if (!render_pipeline_help(pipeline, first)) {
+			tick_t wait_start = time_current();
+			semaphore_wait(&pipeline->recorded);
+			frame_statistics->wait_time += time_diff(wait_start, time_current());
+		}
+	}
+}
+
+static void
+render_pipeline_count_commands(render_pipeline_step_statistics_t* statistics,
+                               render_pipeline_step_t* step) {
+	memset(statistics->commands, 0, sizeof(statistics->commands));
+	statistics->context_fill = 0;
+	for (size_t icontext = 0, csize = array_size(step->contexts); icontext < csize; ++icontext) {
+		render_context_t* context = step->contexts[icontext];
+		size_t cmd_size = render_context_reserved(context);
+		const render_command_t* command = context->commands;
+		for (size_t icmd = 0; icmd < cmd_size; ++icmd, ++command) {
+			if (command->type < RENDERCOMMAND_NUM)
+				++statistics->commands[command->type];
+		}
+		if (context->allocated) {
+			float32_t fill = (float32_t)cmd_size / (float32_t)context->allocated;
+			if (fill > statistics->context_fill)
+				statistics->context_fill = fill;
+		}
+	}
+}
+
+/*! Wait until the step at the given position in dispatch order is recorded and derive its
+depth pre-pass, if any
+\return Time the step was ready for dispatch */
+static tick_t
+render_pipeline_prepare_step(render_pipeline_t* pipeline, size_t iorder,
+                             render_pipeline_statistics_t* frame_statistics) {
+	size_t istep = pipeline->order[iorder];
+	render_pipeline_step_t* step = pipeline->steps + istep;
+	render_pipeline_wait_recorded(pipeline, step, iorder, frame_statistics);
+	// Source step of a pre-pass depends on the pre-pass writing the same target, so it
+	// can still be recording or sorting its contexts and must be waited for as well
+	render_pipeline_step_t* source = nullptr;
+	if (step->depth_source) {
+		FOUNDATION_ASSERT_MSG(step->depth_source > istep + 1,
+		                      "Depth pre-pass must precede its source step");
+		source = pipeline->steps + (step->depth_source - 1);
+		if (source->culled)
+			source = nullptr;
+		else
+			render_pipeline_wait_recorded(pipeline, source, iorder, frame_statistics);
+	}
+	tick_t ready = time_current();
+	if (source)
+		render_pipeline_depth_prepass(pipeline, step);
+	return ready;
+}
+
+bool
 render_pipeline_dispatch(render_pipeline_t* pipeline) {
-	if (pipeline->scheduler) {
-		size_t step_count = array_size(pipeline->steps);
-		while ((size_t)atomic_load32(&pipeline->step_complete, memory_order_acquire) < step_count)
-			thread_yield();
+	size_t order_count = array_size(pipeline->order);
+	size_t slot = (size_t)(pipeline->frame % RENDER_PIPELINE_STATISTICS_FRAMES);
+	render_pipeline_collect_timers(pipeline);
+
+	// Timers of the frame previously in the slot never completed and are dropped
+	render_pipeline_statistics_t* frame_statistics = pipeline->statistics + slot;
+	render_pipeline_release_timer(pipeline->backend, &frame_statistics->gpu_timer);
+	memset(frame_statistics, 0, sizeof(render_pipeline_statistics_t));
+	frame_statistics->frame = pipeline->frame;
+	for (size_t istep = 0, step_count = array_size(pipeline->steps); istep < step_count; ++istep)
+		render_pipeline_release_timer(pipeline->backend,
+		                              &pipeline->steps[istep].statistics[slot].gpu_timer);
+	frame_statistics->gpu_timer = render_backend_timer_begin(pipeline->backend);
+
+	// With idle skipping every step is recorded and hashed before any is dispatched, so
+	// the frame is skipped as a whole or dispatched in full. The back buffer is undefined
+	// after a swap, skipping part of the frame would present it partially rendered
+	render_backend_t* backend = pipeline->backend;
+	bool skip = false;
+	if (backend->skip_idle) {
+		for (size_t iorder = 0; iorder < order_count; ++iorder)
+			render_pipeline_prepare_step(pipeline, iorder, frame_statistics);
+		skip = order_count && !backend->frame_dispatched;
+		for (size_t iorder = 0; skip && (iorder < order_count); ++iorder) {
+			render_pipeline_step_t* step = pipeline->steps + pipeline->order[iorder];
+			skip = render_backend_dispatch_matches(backend, iorder, step->target, step->contexts,
+			                                       array_size(step->contexts));
+		}
 	}
 
-	for (size_t istep = 0, ssize = array_size(pipeline->steps); istep < ssize; ++istep) {
+	bool dispatched = false;
+	for (size_t iorder = 0; iorder < order_count; ++iorder) {
+		size_t istep = pipeline->order[iorder];
 		render_pipeline_step_t* step = pipeline->steps + istep;
+		// Without idle skipping each step is dispatched as soon as it is recorded
+		tick_t dispatch_start = time_current();
+		if (!backend->skip_idle)
+			dispatch_start = render_pipeline_prepare_step(pipeline, iorder, frame_statistics);
+
+		render_pipeline_step_statistics_t* statistics = step->statistics + slot;
+		render_pipeline_count_commands(statistics, step);
+
 		size_t context_count = array_size(step->contexts);
-		render_backend_dispatch(pipeline->backend, step->target, step->contexts, context_count);
+		unsigned int gpu_timer = render_backend_timer_begin(pipeline->backend);
+		bool step_dispatched = render_backend_dispatch_frame(backend, step->target, step->contexts,
+		                                                     context_count, skip);
+		render_backend_timer_end(pipeline->backend, gpu_timer);
+		if (step_dispatched)
+			dispatched = true;
+
+		statistics->frame = pipeline->frame;
+		statistics->executor_time = (tick_t)atomic_load64(&step->executor_time, memory_order_acquire);
+		statistics->sort_time = step->sort_time;
+		statistics->dispatch_time = time_diff(dispatch_start, time_current());
+		statistics->gpu_time = 0;
+		statistics->gpu_timer = gpu_timer;
+		statistics->culled = false;
+		statistics->skipped = !step_dispatched;
+		if (step_dispatched)
+			++frame_statistics->dispatched;
+		else
+			++frame_statistics->skipped;
+	}
+
+	for (size_t istep = 0, step_count = array_size(pipeline->steps); istep < step_count; ++istep) {
+		render_pipeline_step_t* step = pipeline->steps + istep;
+		if (!step->culled)
+			continue;
+		render_pipeline_step_statistics_t* statistics = step->statistics + slot;
+		memset(statistics, 0, sizeof(render_pipeline_step_statistics_t));
+		statistics->frame = pipeline->frame;
+		statistics->culled = true;
+		++frame_statistics->culled;
 	}
+
+	render_backend_timer_end(pipeline->backend, frame_statistics->gpu_timer);
+	frame_statistics->time = time_diff(pipeline->frame_start, time_current());
+	++pipeline->frame;
+	return dispatched;
+}
+
+const render_pipeline_statistics_t*
+render_pipeline_statistics(const render_pipeline_t* pipeline, size_t frames_ago) {
+	if ((frames_ago >= RENDER_PIPELINE_STATISTICS_FRAMES) || (frames_ago >= pipeline->frame))
+		return nullptr;
+	uint64_t frame = pipeline->frame - 1 - frames_ago;
+	return pipeline->statistics + (frame % RENDER_PIPELINE_STATISTICS_FRAMES);
+}
+
+const render_pipeline_step_statistics_t*
+render_pipeline_step_statistics(const render_pipeline_t* pipeline, size_t step,
+                                size_t frames_ago) {
+	if ((frames_ago >= RENDER_PIPELINE_STATISTICS_FRAMES) || (frames_ago >= pipeline->frame) ||
+	    (step >= array_size(pipeline->steps)))
+		return nullptr;
+	uint64_t frame = pipeline->frame - 1 - frames_ago;
+	const render_pipeline_step_statistics_t* statistics =
+	    pipeline->steps[step].statistics + (frame % RENDER_PIPELINE_STATISTICS_FRAMES);
+	// Steps added after the frame was dispatched have no statistics for it
+	return (statistics->frame == frame) ? statistics : nullptr;
 }
 
 void
@@ -126,6 +843,8 @@ render_pipeline_step_initialize(render_pipeline_step_t* step, render_target_t* t
 	step->target = target;
 	step->contexts = nullptr;
 	step->executor = executor;
+	if (target)
+		array_push(step->writes, target);
 }
 
 void
@@ -133,15 +852,81 @@ render_pipeline_step_finalize(render_pipeline_step_t* step) {
 	for (size_t icontext = 0, csize = array_size(step->contexts); icontext < csize; ++icontext)
 		render_context_deallocate(step->contexts[icontext]);
 	array_deallocate(step->contexts);
+	for (size_t ientry = 0, esize = array_size(step->depth_state); ientry < esize; ++ientry) {
+		render_statebuffer_deallocate(step->depth_state[ientry].depth);
+		render_statebuffer_deallocate(step->depth_state[ientry].equal);
+	}
+	array_deallocate(step->depth_state);
+	array_deallocate(step->reads);
+	array_deallocate(step->writes);
+	array_deallocate(step->dependents);
+}
+
+void
+render_pipeline_step_partition(render_pipeline_step_t* step, unsigned int partitions, size_t work,
+                               render_pipeline_partition_fn executor) {
+	FOUNDATION_ASSERT_MSG(array_size(step->contexts) > 0,
+	                      "Partitioned step must have at least one context");
+	step->partitions = partitions;
+	step->partition_work = work;
+	step->partition_executor = executor;
+}
+
+render_target_t*
+render_pipeline_transient_target(render_pipeline_t* pipeline, unsigned int width,
+                                 unsigned int height, pixelformat_t pixelformat,
+                                 colorspace_t colorspace) {
+	render_pipeline_transient_t* transient =
+	    memory_allocate(HASH_RENDER, sizeof(render_pipeline_transient_t), 0,
+	                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	transient->target.width = width;
+	transient->target.height = height;
+	transient->target.pixelformat = pixelformat;
+	transient->target.colorspace = colorspace;
+	array_push(pipeline->transients, transient);
+	return &transient->target;
+}
+
+void
+render_pipeline_step_read(render_pipeline_step_t* step, render_target_t* target) {
+	if (!render_pipeline_target_in(step->reads, target))
+		array_push(step->reads, target);
+}
+
+void
+render_pipeline_step_write(render_pipeline_step_t* step, render_target_t* target) {
+	if (!render_pipeline_target_in(step->writes, target))
+		array_push(step->writes, target);
+}
+
+void
+render_pipeline_add_output(render_pipeline_t* pipeline, render_target_t* target) {
+	if (!render_pipeline_target_in(pipeline->outputs, target))
+		array_push(pipeline->outputs, target);
+}
+
+void
+render_pipeline_step_depth_prepass_initialize(render_pipeline_step_t* step,
+                                              render_target_t* target, size_t source_step,
+                                              render_pipeline_depth_program_fn depth_program) {
+	render_pipeline_step_initialize(step, target, nullptr);
+	step->depth_source = source_step + 1;
+	step->depth_program = depth_program;
 }
 
 void
 render_pipeline_step_blit_initialize(render_pipeline_step_t* step, render_target_t* target_source,
                                      render_target_t* target_destination) {
-	memset(step, 0, sizeof(render_pipeline_step_t));
-	step->target = target_destination;
-	// step->contexts = nullptr;
-	// step->executor = executor;
+	render_pipeline_step_initialize(step, target_destination, nullptr);
+	step->blit_source = target_source;
+	array_push(step->reads, target_source);
+}
 
-	FOUNDATION_UNUSED(target_source);
+void
+render_pipeline_step_blit_scaled_initialize(render_pipeline_step_t* step,
+                                            const render_scaling_t* scaling,
+                                            render_target_t* target_source,
+                                            render_target_t* target_destination) {
+	render_pipeline_step_blit_initialize(step, target_source, target_destination);
+	step->blit_scaling = scaling;
 }
@@ -37,12 +37,44 @@ render_pipeline_finalize(render_pipeline_t* pipeline);
 void
 render_pipeline_deallocate(render_pipeline_t* pipeline);
 
+/*! Build the step dependency graph from the targets steps read and write and record the
+steps. A step reading a target depends on all steps writing it, steps writing the same
+target keep the order they were added in. Steps are recorded as tasks once the steps they
+depend on are recorded. If outputs are added to the pipeline, steps contributing to neither
+an output nor the frame buffer are culled. Must be called on the thread dispatching the
+pipeline, since storage for transient targets is allocated by the backend
+\param pipeline Pipeline */
 void
 render_pipeline_execute(render_pipeline_t* pipeline);
 
-void
+/*! Dispatch all steps not culled, in dependency order. With idle skipping enabled all steps
+are recorded before any is dispatched, and the steps are skipped only if every step is idle
+\param pipeline Pipeline
+\return true if any step was dispatched, false if all steps were skipped as idle
+        (see render_backend_set_skip_idle) */
+bool
 render_pipeline_dispatch(render_pipeline_t* pipeline);
 
+/*! Get the statistics of a dispatched frame. Statistics are kept for the last
+RENDER_PIPELINE_STATISTICS_FRAMES frames and must not be queried while the pipeline
+is dispatched. GPU times are measured with backend GPU timers (see
+render_backend_timer_begin) and collected when a later frame is dispatched, a pending
+GPU timer means the result is not yet available
+\param pipeline Pipeline
+\param frames_ago Number of frames before the last dispatched frame, zero for the last
+\return Frame statistics, null if the frame is not available */
+const render_pipeline_statistics_t*
+render_pipeline_statistics(const render_pipeline_t* pipeline, size_t frames_ago);
+
+/*! Get the statistics of a step in a dispatched frame, see render_pipeline_statistics
+\param pipeline Pipeline
+\param step Index of the step in the pipeline
+\param frames_ago Number of frames before the last dispatched frame, zero for the last
+\return Step statistics, null if the frame is not available for the step */
+const render_pipeline_step_statistics_t*
+render_pipeline_step_statistics(const render_pipeline_t* pipeline, size_t step,
+                                size_t frames_ago);
+
 void
 render_pipeline_step_initialize(render_pipeline_step_t* step, render_target_t* target,
                                 render_pipeline_execute_fn executor);
@@ -50,6 +82,93 @@ render_pipeline_step_initialize(render_pipeline_step_t* step, render_target_t* t
 void
 render_pipeline_step_finalize(render_pipeline_step_t* step);
 
+/*! Record a step in partitions instead of calling the step executor. Each partition is
+recorded by its own task to its own context of the step, given an even share of the work
+items as a range. The contexts are merged and sorted once all partitions are recorded.
+The number of partitions is limited to the number of contexts of the step, which must have
+at least one context. A step without contexts calls the step executor instead. Can be called
+again before executing the pipeline to update the number of work items
+\param step Step
+\param partitions Number of partitions
+\param work Number of work items
+\param executor Function recording the work item range [begin, end) to a context */
+void
+render_pipeline_step_partition(render_pipeline_step_t* step, unsigned int partitions, size_t work,
+                               render_pipeline_partition_fn executor);
+
+/*! Request a transient target owned by the pipeline, used by steps like any other target.
+Storage is served from a pool of targets of the same size and format when the pipeline is
+executed, and transient targets whose steps do not overlap in dispatch order share the
+same storage. Content does not persist between frames, and the storage (including the
+texture in backend data) is only valid from when the pipeline is executed until the next
+execute. Storage no longer used is released through the backend deferred destruction at a
+later flip. Transient targets not used by any step have no storage
+\param pipeline Pipeline
+\param width Width
+\param height Height
+\param pixelformat Pixel format
+\param colorspace Color space
+\return Transient target, valid until the pipeline is finalized */
+render_target_t*
+render_pipeline_transient_target(render_pipeline_t* pipeline, unsigned int width,
+                                 unsigned int height, pixelformat_t pixelformat,
+                                 colorspace_t colorspace);
+
+/*! Declare a target sampled by a step
+\param step Step
+\param target Target */
+void
+render_pipeline_step_read(render_pipeline_step_t* step, render_target_t* target);
+
+/*! Declare a target rendered by a step, in addition to the step target
+\param step Step
+\param target Target */
+void
+render_pipeline_step_write(render_pipeline_step_t* step, render_target_t* target);
+
+/*! Declare a target used outside the pipeline. Once any output is declared, steps not
+contributing to an output or the frame buffer are culled
+\param pipeline Pipeline
+\param target Target */
+void
+render_pipeline_add_output(render_pipeline_t* pipeline, render_target_t* target);
+
+/*! Initialize a depth pre-pass step deriving its commands from the opaque render commands
+of a later step when the pipeline is dispatched. Opaque commands are drawn front to back
+ordered by command depth (see render_command_set_depth) with the position only program
+variant and color writes disabled. The opaque commands of the source step are then drawn
+with an equal depth compare and depth writes disabled, and depth and stencil clears of the
+source step move to the pre-pass. The program variant uses the parameter buffer of the
+source command and must declare its parameters at the same locations
+\param step Step
+\param target Target, same as the target of the source step
+\param source_step Index of the source step in the pipeline, must be after this step
+\param depth_program Function returning the position only variant of a program, or null
+to leave commands using the program out of the pre-pass */
+void
+render_pipeline_step_depth_prepass_initialize(render_pipeline_step_t* step,
+                                              render_target_t* target, size_t source_step,
+                                              render_pipeline_depth_program_fn depth_program);
+
+/*! Initialize a step copying the color of a source target to the step target with a
+framebuffer blit, scaling with linear filtering if the target sizes differ and resolving
+a multisampled source. The source is declared as read by the step
+\param step Step
+\param target_source Source target
+\param target_destination Destination target */
 void
 render_pipeline_step_blit_initialize(render_pipeline_step_t* step, render_target_t* target_source,
                                      render_target_t* target_destination);
+
+/*! Initialize a blit step copying the scaled resolution rectangle of a target rendered
+with resolution scaling to the full destination target, for example the frame buffer
+at native resolution
+\param step Step
+\param scaling Resolution scaling
+\param target_source Source target, rendered at the scaled resolution
+\param target_destination Destination target */
+void
+render_pipeline_step_blit_scaled_initialize(render_pipeline_step_t* step,
+                                            const render_scaling_t* scaling,
+                                            render_target_t* target_source,
+                                            render_target_t* target_destination);
@@ -0,0 +1,164 @@
+/* pool.c  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+
+#include <render/render.h>
+#include <render/internal.h>
+
+#define RENDER_POOL_ALIGN 16
+#define RENDER_POOL_CAPACITY_MAX 0xFFFF
+
+render_pool_t _render_target_pool;
+render_pool_t _render_buffer_pool;
+render_pool_t _render_program_pool;
+
+int
+render_pool_initialize(render_pool_t* pool, size_t size, size_t capacity) {
+	if (capacity > RENDER_POOL_CAPACITY_MAX) {
+		log_warnf(HASH_RENDER, WARNING_INVALID_VALUE,
+		          STRING_CONST("Pool capacity %" PRIsize " exceeds handle range, clamped to %u"),
+		          capacity, (unsigned int)RENDER_POOL_CAPACITY_MAX);
+		capacity = RENDER_POOL_CAPACITY_MAX;
+	}
+
+	pool->stride = (size + (RENDER_POOL_ALIGN - 1)) & ~(size_t)(RENDER_POOL_ALIGN - 1);
+	pool->capacity = capacity;
+	pool->slab = memory_allocate(HASH_RENDER, pool->stride * capacity, RENDER_POOL_ALIGN,
+	                             MEMORY_PERSISTENT);
+	pool->generation = memory_allocate(HASH_RENDER, sizeof(uint16_t) * capacity, 0,
+	                                   MEMORY_PERSISTENT);
+	pool->next = memory_allocate(HASH_RENDER, sizeof(uint32_t) * capacity, 0, MEMORY_PERSISTENT);
+	if (!pool->slab || !pool->generation || !pool->next)
+		return -1;
+
+	for (size_t islot = 0; islot < capacity; ++islot) {
+		pool->generation[islot] = 1;
+		pool->next[islot] = (islot + 1 < capacity) ? (uint32_t)(islot + 2) : 0;
+	}
+	atomic_store64(&pool->free, capacity ? 1 : 0, memory_order_release);
+	return 0;
+}
+
+void
+render_pool_finalize(render_pool_t* pool) {
+	memory_deallocate(pool->slab);
+	memory_deallocate(pool->generation);
+	memory_deallocate(pool->next);
+	memset(pool, 0, sizeof(render_pool_t));
+}
+
+static FOUNDATION_FORCEINLINE bool
+render_pool_contains(const render_pool_t* pool, const void* ptr) {
+	return pool->slab && (ptr >= pool->slab) &&
+	       (ptr < pointer_offset_const(pool->slab, pool->stride * pool->capacity));
+}
+
+void*
+render_pool_allocate(render_pool_t* pool, size_t size) {
+	if (size <= pool->stride) {
+		int64_t head, next;
+		uint32_t slot;
+		do {
+			head = atomic_load64(&pool->free, memory_order_acquire);
+			slot = (uint32_t)(head & 0xFFFFFFFF);
+			if (!slot)
+				break;
+			// Tag in high bits is incremented on every change to avoid ABA
+			next = (int64_t)(((uint64_t)head & 0xFFFFFFFF00000000ULL) + 0x100000000ULL) |
+			       (int64_t)pool->next[slot - 1];
+		} while (!atomic_cas64(&pool->free, next, head, memory_order_acq_rel,
+		                       memory_order_acquire));
+		if (slot) {
+			void* ptr = pointer_offset(pool->slab, pool->stride * (slot - 1));
+			memset(ptr, 0, pool->stride);
+			return ptr;
+		}
+		if (pool->slab)
+			log_warn(HASH_RENDER, WARNING_RESOURCE,
+			         STRING_CONST("Resource pool exhausted, allocating from heap"));
+	}
+	return memory_allocate(HASH_RENDER, size, 8, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+}
+
+void
+render_pool_deallocate(render_pool_t* pool, void* ptr) {
+	if (!render_pool_contains(pool, ptr)) {
+		memory_deallocate(ptr);
+		return;
+	}
+
+	uint32_t slot = (uint32_t)((size_t)pointer_diff(ptr, pool->slab) / pool->stride);
+	// Invalidate all handles to the slot, generation zero is reserved for the invalid handle
+	uint16_t generation = (uint16_t)(pool->generation[slot] + 1);
+	pool->generation[slot] = generation ? generation : 1;
+
+	int64_t head, next;
+	do {
+		head = atomic_load64(&pool->free, memory_order_acquire);
+		pool->next[slot] = (uint32_t)(head & 0xFFFFFFFF);
+		next = (int64_t)(((uint64_t)head & 0xFFFFFFFF00000000ULL) + 0x100000000ULL) |
+		       (int64_t)(slot + 1);
+	} while (!atomic_cas64(&pool->free, next, head, memory_order_acq_rel, memory_order_acquire));
+}
+
+render_handle_t
+render_pool_handle(const render_pool_t* pool, const void* ptr) {
+	if (!ptr || !render_pool_contains(pool, ptr))
+		return RENDER_HANDLE_INVALID;
+	uint32_t slot = (uint32_t)((size_t)pointer_diff(ptr, pool->slab) / pool->stride);
+	return ((render_handle_t)pool->generation[slot] << 16) | (slot + 1);
+}
+
+void*
+render_pool_resolve(const render_pool_t* pool, render_handle_t handle) {
+	uint32_t slot = (handle & 0xFFFF);
+	if (!slot || (slot > pool->capacity) || (pool->generation[slot - 1] != (handle >> 16)))
+		return nullptr;
+	return pointer_offset(pool->slab, pool->stride * (slot - 1));
+}
+
+render_handle_t
+render_buffer_handle(const void* buffer) {
+	return render_pool_handle(&_render_buffer_pool, buffer);
+}
+
+render_buffer_t*
+render_buffer_resolve(render_handle_t handle) {
+	return render_pool_resolve(&_render_buffer_pool, handle);
+}
+
+render_handle_t
+render_program_handle(const render_program_t* program) {
+	return render_pool_handle(&_render_program_pool, program);
+}
+
+render_program_t*
+render_program_resolve(render_handle_t handle) {
+	return render_pool_resolve(&_render_program_pool, handle);
+}
+
+render_handle_t
+render_target_handle(const render_target_t* target) {
+	return render_pool_handle(&_render_target_pool, target);
+}
+
+render_target_t*
+render_target_resolve(render_handle_t handle) {
+	return render_pool_resolve(&_render_target_pool, handle);
+}
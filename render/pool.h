@@ -0,0 +1,71 @@
+/* pool.h  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file pool.h
+    Resource pools and handles. Render targets, buffers and programs are stored in fixed
+    capacity pools sized from render_config_t, and can be referenced by 32-bit handles
+    combining slot index and slot generation. Resolving a handle is O(1) and returns null
+    if the resource has been destroyed, even if the slot has been reused.
+
+    Resources that do not fit a pool slot (for example parameter buffers with many
+    parameters) or that are allocated when the pool is full are allocated from the heap
+    and have no handle. */
+
+#include <foundation/platform.h>
+
+#include <render/types.h>
+
+#define RENDER_HANDLE_INVALID 0
+
+/*! Get handle of a buffer of any type
+\param buffer Buffer
+\return Handle, RENDER_HANDLE_INVALID if buffer is not stored in the buffer pool */
+RENDER_API render_handle_t
+render_buffer_handle(const void* buffer);
+
+/*! Resolve a buffer handle
+\param handle Handle
+\return Buffer, null if handle is stale or invalid */
+RENDER_API render_buffer_t*
+render_buffer_resolve(render_handle_t handle);
+
+/*! Get handle of a program
+\param program Program
+\return Handle, RENDER_HANDLE_INVALID if program is not stored in the program pool */
+RENDER_API render_handle_t
+render_program_handle(const render_program_t* program);
+
+/*! Resolve a program handle
+\param handle Handle
+\return Program, null if handle is stale or invalid */
+RENDER_API render_program_t*
+render_program_resolve(render_handle_t handle);
+
+/*! Get handle of a render target
+\param target Render target
+\return Handle, RENDER_HANDLE_INVALID if target is not stored in the target pool */
+RENDER_API render_handle_t
+render_target_handle(const render_target_t* target);
+
+/*! Resolve a render target handle
+\param handle Handle
+\return Render target, null if handle is stale or invalid */
+RENDER_API render_target_t*
+render_target_resolve(render_handle_t handle);
@@ -26,12 +26,12 @@
 
 //Size expectations for the program compiler and loader
 FOUNDATION_STATIC_ASSERT(sizeof(render_vertex_decl_t) == 128, "invalid vertex decl size");
-FOUNDATION_STATIC_ASSERT(sizeof(render_program_t) <= 308, "invalid program size");
+FOUNDATION_STATIC_ASSERT(sizeof(render_program_t) <= 340, "invalid program size");
 
 render_program_t*
 render_program_allocate(size_t num_parameters) {
 	size_t size = sizeof(render_program_t) + (sizeof(render_parameter_t) * num_parameters);
-	render_program_t* program = memory_allocate(HASH_RENDER, size, 8, MEMORY_PERSISTENT);
+	render_program_t* program = render_pool_allocate(&_render_program_pool, size);
 	render_program_initialize(program, num_parameters);
 	return program;
 }
@@ -57,9 +57,26 @@ render_program_finalize(render_program_t* program) {
 
 void
 render_program_deallocate(render_program_t* program) {
+	if (program && program->backend) {
+		// Remove from lookup immediately, backend object is destroyed at a later flip
+		uuidmap_erase(render_backend_program_table(program->backend), program->uuid);
+		render_backend_queue_destroy(program->backend, &program->destroy, RENDERDESTROY_PROGRAM,
+		                             program);
+		return;
+	}
 	if (program)
 		render_program_finalize(program);
-	memory_deallocate(program);
+	render_pool_deallocate(&_render_program_pool, program);
+}
+
+void
+render_program_destroy(render_program_t* program) {
+	render_shader_unload(program->vertexshader);
+	render_shader_unload(program->pixelshader);
+	program->backend->vtable.deallocate_program(program->backend, program);
+	if (program->parameters != program->inline_parameters)
+		memory_deallocate(program->parameters);
+	render_pool_deallocate(&_render_program_pool, program);
 }
 
 render_program_t*
@@ -76,7 +93,7 @@ render_program_load_impl(render_backend_t* backend, const uuid_t uuid) {
 	uint64_t platform = render_backend_resource_platform(backend);
 	render_program_t* program = nullptr;
 	stream_t* stream = nullptr;
-	void* block;
+	void* block = nullptr;
 	bool success = false;
 	uuid_t* shaderuuid;
 	size_t remain;
@@ -92,6 +109,7 @@ render_program_load_impl(render_backend_t* backend, const uuid_t uuid) {
 	error_context_push(STRING_CONST("loading program"), STRING_ARGS(uuidstr));
 
 	render_backend_enable_thread(backend);
+	tick_t trace = render_trace_begin();
 
 retry:
 
@@ -116,7 +134,7 @@ retry:
 	}
 
 	remain = stream_size(stream) - stream_tell(stream);
-	block = memory_allocate(HASH_RENDER, remain, 8, MEMORY_PERSISTENT);
+	block = render_pool_allocate(&_render_program_pool, remain);
 
 	stream_read(stream, block, remain);
 	stream_deallocate(stream);
@@ -150,10 +168,14 @@ finalize:
 		stream_deallocate(stream);
 
 	if (!success) {
-		render_program_deallocate(program);
+		if (program)
+			render_program_deallocate(program);
+		else if (block)
+			render_pool_deallocate(&_render_program_pool, block);
 		program = nullptr;
 	}
 
+	render_trace_end(trace, STRING_CONST("render_program_load"));
 	error_context_pop();
 
 	return program;
@@ -27,6 +27,25 @@
 
 static bool _render_initialized;
 
+//! Parameters fitting inline in a pooled parameter buffer or program slot, larger are heap allocated
+#define RENDER_POOL_BUFFER_PARAMETERS 8
+#define RENDER_POOL_PROGRAM_PARAMETERS 16
+
+static size_t
+render_pool_buffer_size(void) {
+	size_t size = sizeof(render_parameterbuffer_t) +
+	              (sizeof(render_parameter_t) * RENDER_POOL_BUFFER_PARAMETERS);
+	if (size < sizeof(render_vertexbuffer_t))
+		size = sizeof(render_vertexbuffer_t);
+	if (size < sizeof(render_indexbuffer_t))
+		size = sizeof(render_indexbuffer_t);
+	if (size < sizeof(render_statebuffer_t))
+		size = sizeof(render_statebuffer_t);
+	if (size < sizeof(render_palettebuffer_t))
+		size = sizeof(render_palettebuffer_t);
+	return size;
+}
+
 //Global data
 render_config_t _render_config;
 bool _render_api_disabled[RENDERAPI_NUM];
@@ -46,12 +65,35 @@ render_module_initialize(render_config_t config) {
 	_render_config.program_max = config.program_max    ?
 	                             config.program_max    : 128;
 
+	_render_config.vertex_decl_max = config.vertex_decl_max    ?
+	                                 config.vertex_decl_max    : 256;
+	if (_render_config.vertex_decl_max > RENDER_VERTEX_DECL_MAX)
+		_render_config.vertex_decl_max = RENDER_VERTEX_DECL_MAX;
+
+	_render_config.frames_in_flight = config.frames_in_flight    ?
+	                                  config.frames_in_flight    : 2;
+	if (_render_config.frames_in_flight > RENDER_FRAMES_IN_FLIGHT_MAX)
+		_render_config.frames_in_flight = RENDER_FRAMES_IN_FLIGHT_MAX;
+
 	_render_api_disabled[RENDERAPI_UNKNOWN] = true;
 	_render_api_disabled[RENDERAPI_DEFAULT] = true;
 	_render_api_disabled[RENDERAPI_OPENGL] = true;
 	_render_api_disabled[RENDERAPI_DIRECTX] = true;
 	_render_api_disabled[RENDERAPI_GLES] = true;
 
+	if (render_vertex_decl_table_initialize() < 0)
+		return -1;
+
+	if ((render_pool_initialize(&_render_target_pool, sizeof(render_target_t),
+	                            _render_config.target_max) < 0) ||
+	    (render_pool_initialize(&_render_buffer_pool, render_pool_buffer_size(),
+	                            _render_config.buffer_max) < 0) ||
+	    (render_pool_initialize(&_render_program_pool,
+	                            sizeof(render_program_t) +
+	                                (sizeof(render_parameter_t) * RENDER_POOL_PROGRAM_PARAMETERS),
+	                            _render_config.program_max) < 0))
+		return -1;
+
 	resource_import_register(render_import);
 	resource_compile_register(render_compile);
 
@@ -66,6 +108,11 @@ render_module_finalize(void) {
 		return;
 
 	array_deallocate(_render_backends);
+	render_vertex_decl_table_finalize();
+	render_pool_finalize(&_render_target_pool);
+	render_pool_finalize(&_render_buffer_pool);
+	render_pool_finalize(&_render_program_pool);
+	render_trace_finalize();
 
 	_render_initialized = false;
 }
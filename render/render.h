@@ -32,13 +32,20 @@
 #include <render/sort.h>
 #include <render/indexbuffer.h>
 #include <render/vertexbuffer.h>
+#include <render/vertexformat.h>
+#include <render/mesh.h>
+#include <render/transform.h>
+#include <render/palette.h>
+#include <render/pool.h>
 #include <render/parameter.h>
 #include <render/shader.h>
 #include <render/pipeline.h>
 #include <render/program.h>
 #include <render/projection.h>
+#include <render/scaling.h>
 #include <render/state.h>
 #include <render/texture.h>
+#include <render/trace.h>
 
 #include <render/import.h>
 #include <render/compile.h>
@@ -0,0 +1,169 @@
+/* scaling.c  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+
+#include <render/render.h>
+#include <render/internal.h>
+
+static unsigned int
+render_scaling_dimension(unsigned int native, real scale) {
+	unsigned int dimension = (unsigned int)(((real)native * scale) + REAL_C(0.5));
+	return dimension ? dimension : 1;
+}
+
+static bool
+render_scaling_resize(render_scaling_t* scaling, render_target_t* target) {
+	unsigned int width = render_scaling_dimension(scaling->native_width, scaling->max_scale);
+	unsigned int height = render_scaling_dimension(scaling->native_height, scaling->max_scale);
+	if ((target->width == width) && (target->height == height))
+		return true;
+	return render_target_resize(target, width, height);
+}
+
+static bool
+render_scaling_apply(render_scaling_t* scaling, real scale) {
+	if (scale < scaling->min_scale)
+		scale = scaling->min_scale;
+	if (scale > scaling->max_scale)
+		scale = scaling->max_scale;
+	scaling->scale = scale;
+	unsigned int width = render_scaling_dimension(scaling->native_width, scale);
+	unsigned int height = render_scaling_dimension(scaling->native_height, scale);
+	bool changed = (width != scaling->width) || (height != scaling->height);
+	scaling->width = width;
+	scaling->height = height;
+	return changed;
+}
+
+void
+render_scaling_initialize(render_scaling_t* scaling, unsigned int native_width,
+                          unsigned int native_height, real min_scale, real max_scale,
+                          real target_time) {
+	memset(scaling, 0, sizeof(render_scaling_t));
+	scaling->native_width = native_width;
+	scaling->native_height = native_height;
+	scaling->min_scale = (min_scale > 0) ? min_scale : REAL_C(0.1);
+	scaling->max_scale = (max_scale > scaling->min_scale) ? max_scale : scaling->min_scale;
+	scaling->target_time = target_time;
+	scaling->tolerance = REAL_C(0.1);
+	scaling->frames = 8;
+	scaling->step = REAL_C(0.05);
+	render_scaling_apply(scaling, REAL_C(1.0));
+}
+
+void
+render_scaling_finalize(render_scaling_t* scaling) {
+	array_deallocate(scaling->targets);
+}
+
+void
+render_scaling_set_hysteresis(render_scaling_t* scaling, real tolerance, unsigned int frames,
+                              real step) {
+	scaling->tolerance = tolerance;
+	scaling->frames = frames ? frames : 1;
+	scaling->step = step;
+	scaling->frames_over = 0;
+	scaling->frames_under = 0;
+}
+
+bool
+render_scaling_add_target(render_scaling_t* scaling, render_target_t* target) {
+	array_push(scaling->targets, target);
+	return render_scaling_resize(scaling, target);
+}
+
+bool
+render_scaling_set_native(render_scaling_t* scaling, unsigned int width, unsigned int height) {
+	scaling->native_width = width;
+	scaling->native_height = height;
+	render_scaling_apply(scaling, scaling->scale);
+	bool success = true;
+	for (size_t itarget = 0, tsize = array_size(scaling->targets); itarget < tsize; ++itarget) {
+		if (!render_scaling_resize(scaling, scaling->targets[itarget]))
+			success = false;
+	}
+	return success;
+}
+
+bool
+render_scaling_update(render_scaling_t* scaling, real frame_time) {
+	if ((frame_time <= 0) || (scaling->target_time <= 0))
+		return false;
+
+	// Hysteresis, the scale only changes after a run of frames outside the tolerance
+	if (frame_time > scaling->target_time * (REAL_C(1.0) + scaling->tolerance)) {
+		++scaling->frames_over;
+		scaling->frames_under = 0;
+	} else if (frame_time < scaling->target_time * (REAL_C(1.0) - scaling->tolerance)) {
+		++scaling->frames_under;
+		scaling->frames_over = 0;
+	} else {
+		scaling->frames_over = 0;
+		scaling->frames_under = 0;
+	}
+
+	real scale = scaling->scale;
+	if (scaling->frames_over >= scaling->frames) {
+		// Frame time is assumed proportional to pixel count, the square of the scale
+		scale *= math_sqrt(scaling->target_time / frame_time);
+		scaling->frames_over = 0;
+	} else if (scaling->frames_under >= scaling->frames) {
+		scale += scaling->step;
+		scaling->frames_under = 0;
+	} else {
+		return false;
+	}
+	return render_scaling_apply(scaling, scale);
+}
+
+bool
+render_scaling_update_pipeline(render_scaling_t* scaling, const render_pipeline_t* pipeline) {
+	const render_pipeline_statistics_t* last = render_pipeline_statistics(pipeline, 0);
+	if (!last)
+		return false;
+
+	// Without GPU timers the last frame never has a GPU time or a pending timer
+	real frame_time = 0;
+	uint64_t frame = last->frame;
+	if (!last->gpu_time && !last->gpu_timer) {
+		frame_time = (real)time_ticks_to_seconds(last->time);
+	} else {
+		for (size_t iframe = 0; iframe < RENDER_PIPELINE_STATISTICS_FRAMES; ++iframe) {
+			const render_pipeline_statistics_t* statistics =
+			    render_pipeline_statistics(pipeline, iframe);
+			if (!statistics)
+				return false;
+			if (!statistics->gpu_timer && statistics->gpu_time) {
+				frame_time = (real)statistics->gpu_time / REAL_C(1000000000.0);
+				frame = statistics->frame;
+				break;
+			}
+		}
+	}
+	if ((frame_time <= 0) || (frame + 1 <= scaling->sample_frame))
+		return false;
+	scaling->sample_frame = frame + 1;
+	return render_scaling_update(scaling, frame_time);
+}
+
+void
+render_scaling_viewport(const render_scaling_t* scaling, render_command_t* command, real min_z,
+                        real max_z) {
+	render_command_viewport(command, 0, 0, scaling->width, scaling->height, min_z, max_z);
+}
@@ -0,0 +1,101 @@
+/* scaling.h  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file scaling.h
+    Dynamic resolution scaling. Scaled targets are sized once for the maximum scale and the
+    scene is rendered to the scaled resolution rectangle in the lower left corner using a
+    viewport, so changing the scale never reallocates targets. The scaled image is then
+    copied to the native resolution, see render_pipeline_step_blit_scaled_initialize */
+
+#include <foundation/platform.h>
+
+#include <render/types.h>
+
+/*! Initialize resolution scaling, starting at native scale if within bounds
+\param scaling Resolution scaling
+\param native_width Native width
+\param native_height Native height
+\param min_scale Minimum scale of the native resolution
+\param max_scale Maximum scale of the native resolution
+\param target_time Frame time in seconds to adapt the scale to */
+RENDER_API void
+render_scaling_initialize(render_scaling_t* scaling, unsigned int native_width,
+                          unsigned int native_height, real min_scale, real max_scale,
+                          real target_time);
+
+/*! Finalize resolution scaling, scaled targets are not deallocated
+\param scaling Resolution scaling */
+RENDER_API void
+render_scaling_finalize(render_scaling_t* scaling);
+
+/*! Set the hysteresis of the scale adaption
+\param scaling Resolution scaling
+\param tolerance Relative deviation from the target frame time tolerated without changing
+                 scale, default 0.1
+\param frames Number of consecutive frames outside the tolerance before the scale is
+              changed, default 8
+\param step Scale increase when frames are consistently faster than the target,
+            default 0.05 */
+RENDER_API void
+render_scaling_set_hysteresis(render_scaling_t* scaling, real tolerance, unsigned int frames,
+                              real step);
+
+/*! Add a target rendered at the scaled resolution, resized to fit the maximum scale
+\param scaling Resolution scaling
+\param target Target
+\return true if successful, false if target could not be resized */
+RENDER_API bool
+render_scaling_add_target(render_scaling_t* scaling, render_target_t* target);
+
+/*! Set the native resolution, for example when the window is resized. Scaled targets
+are resized to fit the maximum scale of the new native resolution
+\param scaling Resolution scaling
+\param width Native width
+\param height Native height
+\return true if successful, false if any target could not be resized */
+RENDER_API bool
+render_scaling_set_native(render_scaling_t* scaling, unsigned int width, unsigned int height);
+
+/*! Adapt the scale to a frame time. The scale is lowered in proportion to the pixel cost
+once frames are consistently slower than the target, and raised by the scale step once
+frames are consistently faster than the target
+\param scaling Resolution scaling
+\param frame_time Frame time in seconds
+\return true if the scaled resolution changed, false if not */
+RENDER_API bool
+render_scaling_update(render_scaling_t* scaling, real frame_time);
+
+/*! Adapt the scale to the frame time of a pipeline, using the GPU time of the last frame
+with a collected GPU time, or the CPU time of the last frame if the backend has no GPU
+timers (see render_pipeline_statistics). Each frame is sampled once
+\param scaling Resolution scaling
+\param pipeline Pipeline
+\return true if the scaled resolution changed, false if not */
+RENDER_API bool
+render_scaling_update_pipeline(render_scaling_t* scaling, const render_pipeline_t* pipeline);
+
+/*! Initialize a viewport command covering the scaled resolution rectangle
+\param scaling Resolution scaling
+\param command Command
+\param min_z Minimum depth
+\param max_z Maximum depth */
+RENDER_API void
+render_scaling_viewport(const render_scaling_t* scaling, render_command_t* command, real min_z,
+                        real max_z);
@@ -24,7 +24,7 @@
 #include <resource/platform.h>
 #include <resource/compile.h>
 
-FOUNDATION_STATIC_ASSERT(sizeof(render_shader_t) == 64, "invalid shader size");
+FOUNDATION_STATIC_ASSERT(sizeof(render_shader_t) == 96, "invalid shader size");
 
 render_shader_t*
 render_pixelshader_allocate(void) {
@@ -64,8 +64,19 @@ render_shader_finalize(render_shader_t* shader) {
 
 void
 render_shader_deallocate(render_shader_t* shader) {
-	if (shader)
-		render_shader_finalize(shader);
+	if (shader && shader->backend) {
+		// Remove from lookup immediately, backend object is destroyed at a later flip
+		uuidmap_erase(render_backend_shader_table(shader->backend), shader->uuid);
+		render_backend_queue_destroy(shader->backend, &shader->destroy, RENDERDESTROY_SHADER,
+		                             shader);
+		return;
+	}
+	memory_deallocate(shader);
+}
+
+void
+render_shader_destroy(render_shader_t* shader) {
+	shader->backend->vtable.deallocate_shader(shader->backend, shader);
 	memory_deallocate(shader);
 }
 
@@ -97,6 +108,7 @@ render_shader_load(render_backend_t* backend, const uuid_t uuid) {
 	error_context_push(STRING_CONST("loading shader"), STRING_ARGS(uuidstr));
 
 	render_backend_enable_thread(backend);
+	tick_t trace = render_trace_begin();
 
 retry:
 
@@ -163,6 +175,7 @@ retry:
 		uuidmap_insert(render_backend_shader_table(backend), uuid, shader);
 	}
 
+	render_trace_end(trace, STRING_CONST("render_shader_load"));
 	error_context_pop();
 
 	return shader;
@@ -23,10 +23,12 @@
 
 void
 render_sort_merge(render_context_t** contexts, size_t num_contexts) {
+	tick_t trace = render_trace_begin();
 	for (size_t i = 0, size = num_contexts; i < size; ++i)
 		contexts[i]->order =
 		    radixsort_sort(contexts[i]->sort, contexts[i]->keys,
 		                   (size_t)atomic_load32(&contexts[i]->reserved, memory_order_acquire));
+	render_trace_end(trace, STRING_CONST("render_sort_merge"));
 }
 
 void
@@ -34,16 +36,38 @@ render_sort_reset(render_context_t* context) {
 	atomic_store64(&context->key, 0, memory_order_release);
 }
 
+// Keys hold a segment in the high bits, advanced by every sequential command, and a
+// sequence number in the low bits. Render keys also hold the vertex declaration id
+// between the two, so draws are grouped by layout only within their segment
+#define RENDER_SORT_SEQUENCE_BITS 24
+#define RENDER_SORT_DECL_BITS 16
+#define RENDER_SORT_SEGMENT_SHIFT (RENDER_SORT_SEQUENCE_BITS + RENDER_SORT_DECL_BITS)
+#define RENDER_SORT_SEQUENCE_MASK ((1ULL << RENDER_SORT_SEQUENCE_BITS) - 1ULL)
+
 uint64_t
 render_sort_sequential_key(render_context_t* context) {
-	return (uint64_t)atomic_incr64(&context->key, memory_order_release);
+	// Start a new segment, sorting after every command of the previous segment and before
+	// any render command of the new one
+	int64_t key, next;
+	do {
+		key = atomic_load64(&context->key, memory_order_acquire);
+		next = (int64_t)((((uint64_t)key >> RENDER_SORT_SEGMENT_SHIFT) + 1ULL)
+		                 << RENDER_SORT_SEGMENT_SHIFT);
+	} while (!atomic_cas64(&context->key, next, key, memory_order_release, memory_order_acquire));
+	return (uint64_t)next;
 }
 
 uint64_t
 render_sort_render_key(render_context_t* context, render_buffer_t* vertexbuffer,
                        render_buffer_t* indexbuffer, render_state_t* state) {
-	FOUNDATION_UNUSED(vertexbuffer);
 	FOUNDATION_UNUSED(indexbuffer);
 	FOUNDATION_UNUSED(state);
-	return render_sort_sequential_key(context);
+	// Group by vertex layout to minimize vertex array changes, sequential within layout
+	uint64_t decl_id = 0;
+	if (vertexbuffer && (vertexbuffer->buffertype == RENDERBUFFER_VERTEX))
+		decl_id = ((render_vertexbuffer_t*)vertexbuffer)->decl_id;
+	uint64_t key = (uint64_t)atomic_incr64(&context->key, memory_order_release);
+	uint64_t segment = key >> RENDER_SORT_SEGMENT_SHIFT;
+	return (segment << RENDER_SORT_SEGMENT_SHIFT) | (decl_id << RENDER_SORT_SEQUENCE_BITS) |
+	       (key & RENDER_SORT_SEQUENCE_MASK);
 }
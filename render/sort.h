@@ -30,9 +30,23 @@ render_sort_merge(render_context_t** contexts, size_t num_contexts);
 RENDER_API void
 render_sort_reset(render_context_t* context);
 
+/*! Get sort key for a command executed in record order, like a clear or viewport. Each
+sequential command starts a new segment of the context, ordered after every previously
+keyed command
+\param context Context
+\return Sort key */
 RENDER_API uint64_t
 render_sort_sequential_key(render_context_t* context);
 
+/*! Get sort key for a render command. Render commands stay within the segment started by
+the last sequential command, and are grouped by vertex declaration within the segment and
+in record order within the declaration. Record order is kept for up to 2^24 commands per
+segment
+\param context Context
+\param vertexbuffer Vertex buffer
+\param indexbuffer Index buffer
+\param state State
+\return Sort key */
 RENDER_API uint64_t
 render_sort_render_key(render_context_t* context, render_buffer_t* vertexbuffer,
                        render_buffer_t* indexbuffer, render_state_t* state);
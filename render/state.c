@@ -35,8 +35,8 @@ render_state_default(void) {
 render_statebuffer_t*
 render_statebuffer_allocate(render_backend_t* backend, render_usage_t usage,
                             const render_state_t state) {
-	render_statebuffer_t* statebuffer = memory_allocate(
-	    HASH_RENDER, sizeof(render_statebuffer_t), 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	render_statebuffer_t* statebuffer =
+	    render_pool_allocate(&_render_buffer_pool, sizeof(render_statebuffer_t));
 	render_statebuffer_initialize(statebuffer, backend, usage, state);
 	return statebuffer;
 }
@@ -88,7 +88,7 @@ render_statebuffer_free(render_statebuffer_t* buffer, bool sys, bool aux) {
 
 void
 render_statebuffer_restore(render_statebuffer_t* buffer) {
-	buffer->backend->vtable.allocate_buffer(buffer->backend, (render_buffer_t*)buffer);
+	buffer->store = &buffer->state;
 
 	//...
 	// All loadable resources should have a stream identifier, an offset and a size
@@ -24,8 +24,7 @@
 render_target_t*
 render_target_allocate(render_backend_t* backend, unsigned int width, unsigned int height,
                        pixelformat_t pixelformat, colorspace_t colorspace) {
-	render_target_t* target =
-	    memory_allocate(HASH_RENDER, sizeof(render_target_t), 0, MEMORY_PERSISTENT);
+	render_target_t* target = render_pool_allocate(&_render_target_pool, sizeof(render_target_t));
 	render_target_initialize(target, backend, width, height, pixelformat, colorspace);
 	return target;
 }
@@ -53,7 +52,7 @@ render_target_finalize(render_target_t* target) {
 void
 render_target_deallocate(render_target_t* target) {
 	render_target_finalize(target);
-	memory_deallocate(target);
+	render_pool_deallocate(&_render_target_pool, target);
 }
 
 void
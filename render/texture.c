@@ -24,7 +24,7 @@
 #include <resource/platform.h>
 #include <resource/compile.h>
 
-FOUNDATION_STATIC_ASSERT(sizeof(render_texture_t) == 96, "invalid texture size");
+FOUNDATION_STATIC_ASSERT(sizeof(render_texture_t) == 128, "invalid texture size");
 
 render_texture_t*
 render_texture_allocate(void) {
@@ -50,8 +50,19 @@ render_texture_finalize(render_texture_t* texture) {
 
 void
 render_texture_deallocate(render_texture_t* texture) {
-	if (texture)
-		render_texture_finalize(texture);
+	if (texture && texture->backend) {
+		// Remove from lookup immediately, backend object is destroyed at a later flip
+		uuidmap_erase(render_backend_texture_table(texture->backend), texture->uuid);
+		render_backend_queue_destroy(texture->backend, &texture->destroy, RENDERDESTROY_TEXTURE,
+		                             texture);
+		return;
+	}
+	memory_deallocate(texture);
+}
+
+void
+render_texture_destroy(render_texture_t* texture) {
+	texture->backend->vtable.deallocate_texture(texture->backend, texture);
 	memory_deallocate(texture);
 }
 
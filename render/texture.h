@@ -61,7 +61,7 @@ render_texture_reload(render_texture_t* texture, const uuid_t uuid);
 RENDER_API void
 render_texture_unload(render_texture_t* texture);
 
-#define RENDER_TEXTURE_RESOURCE_VERSION 1
+#define RENDER_TEXTURE_RESOURCE_VERSION 2
 
 #if RESOURCE_ENABLE_LOCAL_SOURCE
 
@@ -0,0 +1,172 @@
+/* trace.c  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+
+#include <render/render.h>
+#include <render/internal.h>
+
+typedef struct render_trace_span_t {
+	const char* name;
+	size_t length;
+	tick_t start;
+	tick_t end;
+	uint64_t frame;
+} render_trace_span_t;
+
+typedef struct render_trace_buffer_t {
+	uint64_t thread;
+	//! Number of spans stored, only written by the owning thread
+	atomic64_t head;
+	render_trace_span_t span[RENDER_TRACE_SPANS_PER_THREAD];
+} render_trace_buffer_t;
+
+static atomic32_t _render_trace_enabled;
+static atomic64_t _render_trace_frame;
+static atomic32_t _render_trace_buffer_count;
+//! Incremented when buffers are released, invalidating buffer indices held by threads
+static atomic32_t _render_trace_session;
+static render_trace_buffer_t* _render_trace_buffer[RENDER_TRACE_THREADS_MAX];
+
+//! Buffer index + 1 in the low 16 bits and session in the high bits, zero if not registered
+FOUNDATION_DECLARE_THREAD_LOCAL(uintptr_t, trace_buffer, 0)
+
+static render_trace_buffer_t*
+render_trace_thread_buffer(void) {
+	uintptr_t session = (uintptr_t)atomic_load32(&_render_trace_session, memory_order_acquire);
+	uintptr_t local = get_thread_trace_buffer();
+	if (local && ((local >> 16) == session))
+		return _render_trace_buffer[(local & 0xFFFF) - 1];
+
+	// Claim a buffer slot once per thread, spans of threads beyond the limit are dropped
+	int32_t index = atomic_exchange_and_add32(&_render_trace_buffer_count, 1, memory_order_acq_rel);
+	if (index >= RENDER_TRACE_THREADS_MAX)
+		return nullptr;
+	render_trace_buffer_t* buffer = memory_allocate(
+	    HASH_RENDER, sizeof(render_trace_buffer_t), 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	buffer->thread = thread_id();
+	_render_trace_buffer[index] = buffer;
+	set_thread_trace_buffer((session << 16) | (uintptr_t)(index + 1));
+	return buffer;
+}
+
+void
+render_trace_enable(bool enable) {
+	atomic_store32(&_render_trace_enabled, enable ? 1 : 0, memory_order_release);
+}
+
+bool
+render_trace_is_enabled(void) {
+	return atomic_load32(&_render_trace_enabled, memory_order_acquire) != 0;
+}
+
+tick_t
+render_trace_begin(void) {
+	if (!atomic_load32(&_render_trace_enabled, memory_order_relaxed))
+		return 0;
+	return time_current();
+}
+
+void
+render_trace_end(tick_t start, const char* name, size_t length) {
+	if (!start)
+		return;
+	render_trace_buffer_t* buffer = render_trace_thread_buffer();
+	if (!buffer)
+		return;
+	int64_t head = atomic_load64(&buffer->head, memory_order_relaxed);
+	render_trace_span_t* span = buffer->span + (head % RENDER_TRACE_SPANS_PER_THREAD);
+	span->name = name;
+	span->length = length;
+	span->start = start;
+	span->end = time_current();
+	span->frame = (uint64_t)atomic_load64(&_render_trace_frame, memory_order_relaxed);
+	atomic_store64(&buffer->head, head + 1, memory_order_release);
+}
+
+void
+render_trace_frame(void) {
+	atomic_incr64(&_render_trace_frame, memory_order_release);
+}
+
+//! Index of the oldest span not yet overwritten in a ring buffer
+static int64_t
+render_trace_tail(int64_t head) {
+	return (head > RENDER_TRACE_SPANS_PER_THREAD) ? head - RENDER_TRACE_SPANS_PER_THREAD : 0;
+}
+
+size_t
+render_trace_write(stream_t* stream, size_t frames) {
+	uint64_t frame = (uint64_t)atomic_load64(&_render_trace_frame, memory_order_acquire);
+	uint64_t first_frame = (frames && (frames <= frame)) ? (frame - frames + 1) : 0;
+	int32_t buffer_count = atomic_load32(&_render_trace_buffer_count, memory_order_acquire);
+	if (buffer_count > RENDER_TRACE_THREADS_MAX)
+		buffer_count = RENDER_TRACE_THREADS_MAX;
+
+	// Timestamps are written in microseconds relative to the earliest span written
+	tick_t origin = 0;
+	for (int32_t ibuf = 0; ibuf < buffer_count; ++ibuf) {
+		render_trace_buffer_t* buffer = _render_trace_buffer[ibuf];
+		int64_t head = buffer ? atomic_load64(&buffer->head, memory_order_acquire) : 0;
+		for (int64_t ispan = render_trace_tail(head); ispan < head; ++ispan) {
+			const render_trace_span_t* span =
+			    buffer->span + (ispan % RENDER_TRACE_SPANS_PER_THREAD);
+			if ((span->frame >= first_frame) && (!origin || (span->start < origin)))
+				origin = span->start;
+		}
+	}
+	double us_per_tick = 1000000.0 / (double)time_ticks_per_second();
+
+	size_t written = 0;
+	stream_write_string(stream, STRING_CONST("{\"traceEvents\":["));
+	for (int32_t ibuf = 0; ibuf < buffer_count; ++ibuf) {
+		render_trace_buffer_t* buffer = _render_trace_buffer[ibuf];
+		int64_t head = buffer ? atomic_load64(&buffer->head, memory_order_acquire) : 0;
+		for (int64_t ispan = render_trace_tail(head); ispan < head; ++ispan) {
+			const render_trace_span_t* span =
+			    buffer->span + (ispan % RENDER_TRACE_SPANS_PER_THREAD);
+			if (span->frame < first_frame)
+				continue;
+			stream_write_format(
+			    stream,
+			    STRING_CONST("%s{\"name\":\"%.*s\",\"cat\":\"render\",\"ph\":\"X\",\"ts\":%.3f,"
+			                 "\"dur\":%.3f,\"pid\":0,\"tid\":%" PRIu64 ",\"args\":{\"frame\":%" PRIu64
+			                 "}}"),
+			    written ? "," : "", (int)span->length, span->name,
+			    (double)(span->start - origin) * us_per_tick,
+			    (double)(span->end - span->start) * us_per_tick, buffer->thread, span->frame);
+			++written;
+		}
+	}
+	stream_write_string(stream, STRING_CONST("],\"displayTimeUnit\":\"ms\"}"));
+	return written;
+}
+
+void
+render_trace_finalize(void) {
+	atomic_store32(&_render_trace_enabled, 0, memory_order_release);
+	int32_t buffer_count = atomic_load32(&_render_trace_buffer_count, memory_order_acquire);
+	if (buffer_count > RENDER_TRACE_THREADS_MAX)
+		buffer_count = RENDER_TRACE_THREADS_MAX;
+	for (int32_t ibuf = 0; ibuf < buffer_count; ++ibuf) {
+		memory_deallocate(_render_trace_buffer[ibuf]);
+		_render_trace_buffer[ibuf] = nullptr;
+	}
+	atomic_store32(&_render_trace_buffer_count, 0, memory_order_release);
+	atomic_incr32(&_render_trace_session, memory_order_release);
+}
@@ -0,0 +1,66 @@
+/* trace.h  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file trace.h
+    Frame tracing. When enabled, timed spans of recording, sorting, dispatch, uploads and
+    flips are stored in a ring buffer per thread without locking, and can be written for
+    the last frames in Chrome trace event format for viewing in standard trace viewers */
+
+#include <foundation/platform.h>
+
+#include <render/types.h>
+
+/*! Enable or disable tracing
+\param enable true to record spans, false to stop recording */
+RENDER_API void
+render_trace_enable(bool enable);
+
+/*! Query if tracing is enabled
+\return true if spans are recorded, false if not */
+RENDER_API bool
+render_trace_is_enabled(void);
+
+/*! Begin a span on the calling thread
+\return Span start, zero if tracing is disabled */
+RENDER_API tick_t
+render_trace_begin(void);
+
+/*! End a span on the calling thread and store it in the ring buffer of the thread
+\param start Span start returned by render_trace_begin, span is ignored if zero
+\param name Span name, must be a constant string
+\param length Length of name */
+RENDER_API void
+render_trace_end(tick_t start, const char* name, size_t length);
+
+/*! Mark the end of a frame, spans ended after this belong to the next frame. Called by
+render_backend_flip */
+RENDER_API void
+render_trace_frame(void);
+
+/*! Write the spans of the last frames as Chrome trace event JSON. Should be called while
+no spans are recorded, spans overwritten while writing are dropped
+\param stream Stream to write to
+\param frames Number of frames to write, including the frame in progress
+\return Number of spans written */
+RENDER_API size_t
+render_trace_write(stream_t* stream, size_t frames);
+
+#define RENDER_TRACE_THREADS_MAX 64
+#define RENDER_TRACE_SPANS_PER_THREAD 8192
@@ -0,0 +1,135 @@
+/* transform.c  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+
+#include <render/render.h>
+#include <render/internal.h>
+
+#include <vector/matrix.h>
+
+#if FOUNDATION_ARCH_SSE2
+#include <emmintrin.h>
+#elif FOUNDATION_ARCH_NEON
+#include <arm_neon.h>
+#endif
+
+void
+render_transform_store(void* destination, const matrix_t* matrix) {
+	const float32_t* source = (const float32_t*)matrix;
+	float32_t* out = destination;
+#if FOUNDATION_ARCH_SSE2
+	__m128 row0 = _mm_loadu_ps(source);
+	__m128 row1 = _mm_loadu_ps(source + 4);
+	__m128 row2 = _mm_loadu_ps(source + 8);
+	__m128 row3 = _mm_loadu_ps(source + 12);
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+	_mm_storeu_ps(out, row0);
+	_mm_storeu_ps(out + 4, row1);
+	_mm_storeu_ps(out + 8, row2);
+	_mm_storeu_ps(out + 12, row3);
+#elif FOUNDATION_ARCH_NEON
+	float32x4x4_t rows = {{vld1q_f32(source), vld1q_f32(source + 4), vld1q_f32(source + 8),
+	                       vld1q_f32(source + 12)}};
+	vst4q_f32(out, rows);
+#else
+	for (unsigned int row = 0; row < 4; ++row) {
+		for (unsigned int col = 0; col < 4; ++col)
+			out[(col * 4) + row] = source[(row * 4) + col];
+	}
+#endif
+}
+
+/*! Multiply model by view-projection and store result in row major or column major layout */
+static void
+render_transform_multiply_store(float32_t* out, const float32_t* model, const float32_t* viewproj,
+                                bool column_major) {
+#if FOUNDATION_ARCH_SSE2
+	const __m128 vp0 = _mm_loadu_ps(viewproj);
+	const __m128 vp1 = _mm_loadu_ps(viewproj + 4);
+	const __m128 vp2 = _mm_loadu_ps(viewproj + 8);
+	const __m128 vp3 = _mm_loadu_ps(viewproj + 12);
+	__m128 result[4];
+	for (unsigned int row = 0; row < 4; ++row) {
+		__m128 m = _mm_loadu_ps(model + (row * 4));
+		__m128 r = _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(0, 0, 0, 0)), vp0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)), vp1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2)), vp2));
+		result[row] = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(m, m, _MM_SHUFFLE(3, 3, 3, 3)), vp3));
+	}
+	if (column_major)
+		_MM_TRANSPOSE4_PS(result[0], result[1], result[2], result[3]);
+	_mm_storeu_ps(out, result[0]);
+	_mm_storeu_ps(out + 4, result[1]);
+	_mm_storeu_ps(out + 8, result[2]);
+	_mm_storeu_ps(out + 12, result[3]);
+#elif FOUNDATION_ARCH_NEON
+	const float32x4_t vp0 = vld1q_f32(viewproj);
+	const float32x4_t vp1 = vld1q_f32(viewproj + 4);
+	const float32x4_t vp2 = vld1q_f32(viewproj + 8);
+	const float32x4_t vp3 = vld1q_f32(viewproj + 12);
+	float32x4x4_t result;
+	for (unsigned int row = 0; row < 4; ++row) {
+		const float32_t* m = model + (row * 4);
+		float32x4_t r = vmulq_n_f32(vp0, m[0]);
+		r = vmlaq_n_f32(r, vp1, m[1]);
+		r = vmlaq_n_f32(r, vp2, m[2]);
+		result.val[row] = vmlaq_n_f32(r, vp3, m[3]);
+	}
+	if (column_major) {
+		vst4q_f32(out, result);
+	} else {
+		for (unsigned int row = 0; row < 4; ++row)
+			vst1q_f32(out + (row * 4), result.val[row]);
+	}
+#else
+	for (unsigned int row = 0; row < 4; ++row) {
+		for (unsigned int col = 0; col < 4; ++col) {
+			size_t index = column_major ? ((col * 4) + row) : ((row * 4) + col);
+			out[index] = (model[(row * 4) + 0] * viewproj[col]) +
+			             (model[(row * 4) + 1] * viewproj[4 + col]) +
+			             (model[(row * 4) + 2] * viewproj[8 + col]) +
+			             (model[(row * 4) + 3] * viewproj[12 + col]);
+		}
+	}
+#endif
+}
+
+void
+render_transform_store_batch(const matrix_t* viewproj, const matrix_t* model, size_t count,
+                             render_parameterbuffer_t** buffers,
+                             const render_parameter_t* parameter) {
+	if ((parameter->type != RENDERPARAMETER_MATRIX) &&
+	    (parameter->type != RENDERPARAMETER_MATRIX_COLUMN)) {
+		log_warn(HASH_RENDER, WARNING_INVALID_VALUE,
+		         STRING_CONST("Transform batch requires a matrix parameter"));
+		return;
+	}
+
+	const float32_t* vp = (const float32_t*)viewproj;
+	bool column_major = (parameter->type == RENDERPARAMETER_MATRIX_COLUMN);
+	for (size_t iobj = 0; iobj < count; ++iobj) {
+		render_parameterbuffer_t* buffer = buffers[iobj];
+		if (!buffer->store)
+			continue;
+		FOUNDATION_ASSERT((size_t)parameter->offset + (sizeof(float32_t) * 16) <= buffer->buffersize);
+		render_transform_multiply_store(pointer_offset(buffer->store, parameter->offset),
+		                                (const float32_t*)(model + iobj), vp, column_major);
+		buffer->generation = render_buffer_generation();
+	}
+}
@@ -0,0 +1,52 @@
+/* transform.h  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file transform.h
+    Transform matrix storage. Matrix parameters are stored in row major layout like
+    matrix_t and transposed by the backends on upload, so matrices can be copied as is
+    into parameter buffers. Column major matrix parameters and palette buffers store
+    matrices in the layout read by shaders and are uploaded as is. */
+
+#include <foundation/platform.h>
+
+#include <render/types.h>
+#include <vector/types.h>
+
+/*! Store a row major matrix transposed to column major layout, as read by shaders
+from palette buffers
+\param destination Destination storage
+\param matrix Matrix */
+RENDER_API void
+render_transform_store(void* destination, const matrix_t* matrix);
+
+/*! Compute model-view-projection matrices for a batch of objects and store them in the
+layout of the parameter, row major or column major, directly in the parameter buffer
+storage, without locking buffers.
+The caller must guarantee no buffer in the batch is locked or used by a dispatch in
+progress. The generation of each written buffer is bumped.
+\param viewproj View-projection matrix, for example from render_projection_perspective
+\param model Array of model matrices
+\param count Number of model matrices
+\param buffers Parameter buffers receiving the matrices, one per model matrix
+\param parameter Matrix parameter giving the layout and the offset in each parameter buffer */
+RENDER_API void
+render_transform_store_batch(const matrix_t* viewproj, const matrix_t* model, size_t count,
+                             render_parameterbuffer_t** buffers,
+                             const render_parameter_t* parameter);
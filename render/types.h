@@ -71,14 +71,29 @@ typedef enum render_usage_t {
 	RENDERUSAGE_NORENDER,
 	RENDERUSAGE_DYNAMIC,
 	RENDERUSAGE_STATIC,
-	RENDERUSAGE_TARGET
+	RENDERUSAGE_TARGET,
+	RENDERUSAGE_NUM
 } render_usage_t;
 
+typedef enum render_resource_type_t {
+	RENDERRESOURCE_VERTEXBUFFER = 0,
+	RENDERRESOURCE_INDEXBUFFER,
+	RENDERRESOURCE_PARAMETERBUFFER,
+	RENDERRESOURCE_STATEBUFFER,
+	RENDERRESOURCE_PALETTEBUFFER,
+	RENDERRESOURCE_TEXTURE,
+	RENDERRESOURCE_TARGET,
+	RENDERRESOURCE_NUM
+} render_resource_type_t;
+
 typedef enum render_buffer_type_t {
 	RENDERBUFFER_COLOR = 0x01,
 	RENDERBUFFER_DEPTH = 0x02,
 	RENDERBUFFER_STENCIL = 0x04,
 
+	//! Matrix palette for skinning
+	RENDERBUFFER_PALETTE = 0x08,
+
 	RENDERBUFFER_VERTEX = 0x10,
 	RENDERBUFFER_INDEX = 0x20,
 	RENDERBUFFER_PARAMETER = 0x40,
@@ -94,6 +109,10 @@ typedef enum render_buffer_uploadpolicy_t {
 typedef enum render_buffer_flag_t {
 	RENDERBUFFER_DIRTY = 0x01,
 	RENDERBUFFER_LOST = 0x02,
+	//! Drop system memory store after upload and restore on demand (static buffers only)
+	RENDERBUFFER_DISCARD = 0x04,
+	//! System memory store has been dropped
+	RENDERBUFFER_DISCARDED = 0x08,
 
 	RENDERBUFFER_LOCK_READ = 0x10,
 	RENDERBUFFER_LOCK_WRITE = 0x20,
@@ -122,6 +141,20 @@ typedef enum render_vertex_format_t {
 	VERTEXFORMAT_INT2,
 	VERTEXFORMAT_INT4,
 
+	//! Half precision float
+	VERTEXFORMAT_HALF2,
+	VERTEXFORMAT_HALF4,
+
+	//! Signed normalized
+	VERTEXFORMAT_SHORT2_SNORM,
+	VERTEXFORMAT_SHORT4_SNORM,
+	//! Unsigned normalized
+	VERTEXFORMAT_USHORT2_UNORM,
+	VERTEXFORMAT_USHORT4_UNORM,
+
+	//! Signed normalized packed 10:10:10:2 (x in low bits)
+	VERTEXFORMAT_INT1010102_SNORM,
+
 	VERTEXFORMAT_NUMTYPES,
 	VERTEXFORMAT_UNUSED = 255
 } render_vertex_format_t;
@@ -134,6 +167,11 @@ typedef enum render_index_format_t {
 } render_index_format_t;
 
 #define RENDER_MAX_ATTRIBUTES 16
+#define RENDER_MAX_VERTEX_BINDINGS 4
+#define RENDER_FRAMES_IN_FLIGHT_MAX 3
+//! Vertex declaration ids are stored in 16 bits of render sort keys
+#define RENDER_VERTEX_DECL_MAX 65535
+#define RENDER_PIPELINE_STATISTICS_FRAMES 32
 
 typedef enum render_vertex_attribute_id {
 	VERTEXATTRIBUTE_POSITION = 0,
@@ -160,7 +198,12 @@ typedef enum render_parameter_type_t {
 	RENDERPARAMETER_INT4,
 	RENDERPARAMETER_MATRIX,
 	RENDERPARAMETER_TEXTURE,
-	RENDERPARAMETER_ATTRIBUTE
+	RENDERPARAMETER_ATTRIBUTE,
+	//! Matrix palette, sourced from the palette buffer of the render command
+	RENDERPARAMETER_PALETTE,
+	//! Matrix stored in column major layout and uploaded without transpose. Opt in by
+	//! declaring the parameter with this type when allocating the parameter buffer
+	RENDERPARAMETER_MATRIX_COLUMN
 } render_parameter_type_t;
 
 typedef enum render_texture_type_t {
@@ -251,8 +294,10 @@ typedef enum render_command_id {
 	RENDERCOMMAND_INVALID = 0,
 	RENDERCOMMAND_CLEAR,
 	RENDERCOMMAND_VIEWPORT,
+	RENDERCOMMAND_BLIT,
 	RENDERCOMMAND_RENDER_TRIANGLELIST,
-	RENDERCOMMAND_RENDER_LINELIST
+	RENDERCOMMAND_RENDER_LINELIST,
+	RENDERCOMMAND_NUM
 } render_command_id;
 
 typedef struct render_backend_vtable_t render_backend_vtable_t;
@@ -262,13 +307,16 @@ typedef struct render_target_t render_target_t;
 typedef struct render_context_t render_context_t;
 typedef struct render_command_clear_t render_command_clear_t;
 typedef struct render_command_viewport_t render_command_viewport_t;
+typedef struct render_command_blit_t render_command_blit_t;
 typedef struct render_command_render_t render_command_render_t;
 typedef struct render_command_t render_command_t;
 typedef struct render_vertex_attribute_t render_vertex_attribute_t;
 typedef struct render_vertex_decl_t render_vertex_decl_t;
 typedef struct render_buffer_t render_buffer_t;
+typedef struct render_buffer_backing_t render_buffer_backing_t;
 typedef struct render_vertexbuffer_t render_vertexbuffer_t;
 typedef struct render_indexbuffer_t render_indexbuffer_t;
+typedef struct render_palettebuffer_t render_palettebuffer_t;
 typedef struct render_shader_t render_shader_t;
 typedef struct render_shader_ref_t render_shader_ref_t;
 typedef struct render_vertexshader_t render_vertexshader_t;
@@ -285,6 +333,22 @@ typedef struct render_statebuffer_t render_statebuffer_t;
 typedef struct render_pipeline_t render_pipeline_t;
 typedef struct render_pipeline_step_t render_pipeline_step_t;
 typedef struct render_config_t render_config_t;
+typedef struct render_backend_statistics_t render_backend_statistics_t;
+typedef struct render_memory_usage_t render_memory_usage_t;
+typedef struct render_backend_memory_t render_backend_memory_t;
+typedef struct render_destroy_t render_destroy_t;
+typedef struct render_pool_t render_pool_t;
+typedef struct render_view_t render_view_t;
+typedef struct render_pipeline_depth_state_t render_pipeline_depth_state_t;
+typedef struct render_pipeline_transient_t render_pipeline_transient_t;
+typedef struct render_pipeline_storage_t render_pipeline_storage_t;
+typedef struct render_pipeline_step_statistics_t render_pipeline_step_statistics_t;
+typedef struct render_pipeline_statistics_t render_pipeline_statistics_t;
+typedef struct render_scaling_t render_scaling_t;
+
+/*! Resource handle, slot index in the low 16 bits and slot generation in the high 16 bits.
+Zero is never a valid handle */
+typedef uint32_t render_handle_t;
 
 typedef bool (*render_backend_construct_fn)(render_backend_t*);
 typedef void (*render_backend_destruct_fn)(render_backend_t*);
@@ -297,10 +361,12 @@ typedef bool (*render_backend_set_drawable_fn)(render_backend_t*, const render_d
 typedef void (*render_backend_dispatch_fn)(render_backend_t*, render_target_t*, render_context_t**,
                                            size_t);
 typedef void (*render_backend_flip_fn)(render_backend_t*);
+typedef void (*render_memory_budget_fn)(render_backend_t*, const render_memory_usage_t*, void*);
 typedef void* (*render_backend_allocate_buffer_fn)(render_backend_t*, render_buffer_t*);
 typedef void (*render_backend_deallocate_buffer_fn)(render_backend_t*, render_buffer_t*, bool,
                                                     bool);
 typedef bool (*render_backend_upload_buffer_fn)(render_backend_t*, render_buffer_t*);
+typedef bool (*render_backend_upload_buffers_fn)(render_backend_t*, render_buffer_t**, size_t);
 typedef bool (*render_backend_upload_shader_fn)(render_backend_t*, render_shader_t*, const void*,
                                                 size_t);
 typedef bool (*render_backend_upload_program_fn)(render_backend_t*, render_program_t*);
@@ -318,8 +384,14 @@ typedef bool (*render_backend_allocate_target_fn)(render_backend_t*, render_targ
 typedef bool (*render_backend_resize_target_fn)(render_backend_t*, render_target_t*, unsigned int,
                                                 unsigned int);
 typedef void (*render_backend_deallocate_target_fn)(render_backend_t*, render_target_t*);
+typedef unsigned int (*render_backend_timer_begin_fn)(render_backend_t*);
+typedef void (*render_backend_timer_end_fn)(render_backend_t*, unsigned int);
+typedef bool (*render_backend_timer_result_fn)(render_backend_t*, unsigned int, uint64_t*);
 typedef void (*render_pipeline_execute_fn)(render_backend_t*, render_target_t* target,
                                            render_context_t**, size_t);
+typedef void (*render_pipeline_partition_fn)(render_backend_t*, render_target_t* target,
+                                             render_context_t*, size_t, size_t);
+typedef render_program_t* (*render_pipeline_depth_program_fn)(render_program_t*);
 
 struct render_config_t {
 	/*! Maximum number of concurrently allocated render targets */
@@ -328,6 +400,74 @@ struct render_config_t {
 	size_t buffer_max;
 	/*! Maximum number of concurrently allocated programs */
 	size_t program_max;
+	/*! Maximum number of unique vertex declarations, at most RENDER_VERTEX_DECL_MAX */
+	size_t vertex_decl_max;
+	/*! Maximum number of frames queued to the GPU before flip blocks, 1 to 3 */
+	size_t frames_in_flight;
+};
+
+struct render_backend_statistics_t {
+	/*! Number of draws that uploaded parameter buffer values to the program */
+	uint64_t parameter_uploads;
+	/*! Number of draws that skipped parameter upload since the program already
+	had the unchanged values of the same parameter buffer */
+	uint64_t parameter_skips;
+};
+
+struct render_memory_usage_t {
+	//! Bytes of system memory currently allocated
+	uint64_t system;
+	//! Estimated bytes of GPU memory currently allocated
+	uint64_t gpu;
+	//! Highest system memory usage since creation or last peak reset
+	uint64_t system_peak;
+	//! Highest estimated GPU memory usage since creation or last peak reset
+	uint64_t gpu_peak;
+};
+
+struct render_view_t {
+	//! Target receiving the view
+	render_target_t* target;
+	//! Horizontal offset of view rectangle in target
+	unsigned int x;
+	//! Vertical offset of view rectangle in target
+	unsigned int y;
+	//! Width of view rectangle, zero to use the entire target
+	unsigned int width;
+	//! Height of view rectangle, zero to use the entire target
+	unsigned int height;
+	//! Parameter buffers substituted for the view parameter buffers of the dispatch,
+	//! in the same order
+	render_parameterbuffer_t** parameters;
+};
+
+struct render_backend_memory_t {
+	//! System memory bytes per resource type and usage
+	atomic64_t system[RENDERRESOURCE_NUM][RENDERUSAGE_NUM];
+	//! Estimated GPU memory bytes per resource type and usage
+	atomic64_t gpu[RENDERRESOURCE_NUM][RENDERUSAGE_NUM];
+	//! High-water marks matching system
+	atomic64_t system_peak[RENDERRESOURCE_NUM][RENDERUSAGE_NUM];
+	//! High-water marks matching gpu
+	atomic64_t gpu_peak[RENDERRESOURCE_NUM][RENDERUSAGE_NUM];
+	//! Total system memory bytes
+	atomic64_t system_total;
+	//! Total estimated GPU memory bytes
+	atomic64_t gpu_total;
+	//! High-water mark of total system memory bytes
+	atomic64_t system_total_peak;
+	//! High-water mark of total estimated GPU memory bytes
+	atomic64_t gpu_total_peak;
+	//! System memory budget in bytes, zero if unlimited
+	uint64_t system_budget;
+	//! GPU memory budget in bytes, zero if unlimited
+	uint64_t gpu_budget;
+	//! Callback when total usage crosses a budget
+	render_memory_budget_fn budget_callback;
+	//! Callback user data
+	void* budget_userdata;
+	//! Set while over budget, callback is only called when crossing into over budget
+	atomic32_t over_budget;
 };
 
 struct render_backend_vtable_t {
@@ -342,6 +482,7 @@ struct render_backend_vtable_t {
 	render_backend_flip_fn flip;
 	render_backend_allocate_buffer_fn allocate_buffer;
 	render_backend_upload_buffer_fn upload_buffer;
+	render_backend_upload_buffers_fn upload_buffers;
 	render_backend_upload_shader_fn upload_shader;
 	render_backend_upload_program_fn upload_program;
 	render_backend_upload_texture_fn upload_texture;
@@ -355,6 +496,9 @@ struct render_backend_vtable_t {
 	render_backend_allocate_target_fn allocate_target;
 	render_backend_resize_target_fn resize_target;
 	render_backend_deallocate_target_fn deallocate_target;
+	render_backend_timer_begin_fn timer_begin;
+	render_backend_timer_end_fn timer_end;
+	render_backend_timer_result_fn timer_result;
 };
 
 struct render_drawable_t {
@@ -396,6 +540,18 @@ struct render_drawable_t {
 #define RENDER_32BIT_PADDING_ARR(...)
 #endif
 
+//! Deferred destruction of a resource released from any thread, embedded in the resource
+struct render_destroy_t {
+	render_destroy_t* next;
+	RENDER_32BIT_PADDING(nextptr)
+	void* object;
+	RENDER_32BIT_PADDING(objectptr)
+	//! Frame the resource was released in
+	uint64_t frame;
+	unsigned int type;
+	unsigned int unused;
+};
+
 struct render_target_t {
 	render_backend_t* backend;
 	RENDER_32BIT_PADDING(backendptr)
@@ -404,23 +560,58 @@ struct render_target_t {
 	pixelformat_t pixelformat;
 	colorspace_t colorspace;
 	uintptr_t backend_data[4];
+	//! Hash of the last command stream dispatched to the target, zero if the content is
+	//! unknown and the next dispatch to the target can not be skipped as idle
+	uint64_t dispatch_hash;
+	render_destroy_t destroy;
 };
 
-#define RENDER_DECLARE_BACKEND      \
-	render_api_t api;               \
-	render_api_group_t api_group;   \
-	render_backend_vtable_t vtable; \
-	render_drawable_t drawable;     \
-	pixelformat_t pixelformat;      \
-	colorspace_t colorspace;        \
-	render_target_t framebuffer;    \
-	uint64_t concurrency;           \
-	uint64_t framecount;            \
-	uint64_t platform;              \
-	mutex_t* exclusive;             \
-	uuidmap_fixed_t shadertable;    \
-	uuidmap_fixed_t programtable;   \
-	uuidmap_fixed_t texturetable
+#define RENDER_DECLARE_BACKEND              \
+	render_api_t api;                       \
+	render_api_group_t api_group;           \
+	render_backend_vtable_t vtable;         \
+	render_drawable_t drawable;             \
+	pixelformat_t pixelformat;              \
+	colorspace_t colorspace;                \
+	render_target_t framebuffer;            \
+	uint64_t concurrency;                   \
+	uint64_t framecount;                    \
+	uint64_t platform;                      \
+	mutex_t* exclusive;                     \
+	uuidmap_fixed_t shadertable;            \
+	uuidmap_fixed_t programtable;           \
+	uuidmap_fixed_t texturetable;           \
+	render_buffer_t** uploadqueue;          \
+	uint32_t uploadpass;                    \
+	atomicptr_t destroyqueue;               \
+	render_destroy_t* destroypending;       \
+	render_backend_statistics_t statistics; \
+	render_backend_memory_t memory;         \
+	const render_view_t* view;              \
+	bool skip_idle;                         \
+	unsigned int frame_dispatched;          \
+	unsigned int frame_skipped;             \
+	unsigned int frame_slots;               \
+	bool frame_framebuffer_skipped;         \
+	bool frame_incomplete;                  \
+	uint64_t* dispatch_slot_hash;           \
+	atomic32_t texture_generation
+
+//! Fixed capacity slab of equally sized resource slots
+struct render_pool_t {
+	//! Contiguous slot storage
+	void* slab;
+	//! Size in bytes of a slot
+	size_t stride;
+	//! Number of slots
+	size_t capacity;
+	//! Generation of each slot, incremented when the slot is freed
+	uint16_t* generation;
+	//! Free list links, slot index + 1 of next free slot
+	uint32_t* next;
+	//! Free list head, slot index + 1 in low 32 bits and ABA tag in high 32 bits
+	atomic64_t free;
+};
 
 struct render_backend_t {
 	RENDER_DECLARE_BACKEND;
@@ -472,22 +663,58 @@ struct render_command_viewport_t {
 	real max_z;
 };
 
+struct render_command_blit_t {
+	//! Target copied from, the dispatched target is the destination
+	render_target_t* source;
+	//! Source rectangle, zero width or height for the full source target
+	int source_x;
+	int source_y;
+	int source_width;
+	int source_height;
+	//! Destination rectangle, zero width or height for the full destination target
+	int x;
+	int y;
+	int width;
+	int height;
+	unsigned int buffer_mask;
+};
+
 struct render_command_render_t {
 	render_program_t* program;
 	render_vertexbuffer_t* vertexbuffer;
 	render_indexbuffer_t* indexbuffer;
 	render_parameterbuffer_t* parameterbuffer;
 	render_statebuffer_t* statebuffer;
+	//! Handles of program and buffers above, resolved at dispatch to detect stale references.
+	//! Zero for resources not stored in a pool, which are used as is
+	render_handle_t program_handle;
+	render_handle_t vertexbuffer_handle;
+	render_handle_t indexbuffer_handle;
+	render_handle_t parameterbuffer_handle;
+	render_handle_t statebuffer_handle;
+	//! Vertex buffers for binding slots 1 and up, null if not bound
+	render_vertexbuffer_t* vertexstream[RENDER_MAX_VERTEX_BINDINGS - 1];
+	//! Matrix palette buffer for skinning, null if not used
+	render_palettebuffer_t* palettebuffer;
+	//! Handles of vertex streams and palette buffer, resolved at dispatch like the handles above
+	render_handle_t vertexstream_handle[RENDER_MAX_VERTEX_BINDINGS - 1];
+	render_handle_t palettebuffer_handle;
+	//! Offset in matrices of first bone in palette buffer
+	unsigned int palette_offset;
+	//! View space depth, used to order derived depth passes front to back
+	float32_t depth;
 };
 
 struct render_command_t {
 	unsigned int type : 16;
-	unsigned int reserved : 16;
+	//! View parameter buffer index + 1 during a multi-view dispatch, zero if not substituted
+	unsigned int view : 16;
 	unsigned int count;
 
 	union {
 		render_command_clear_t clear;
 		render_command_viewport_t viewport;
+		render_command_blit_t blit;
 		render_command_render_t render;
 	} data;
 };
@@ -495,7 +722,7 @@ struct render_command_t {
 struct render_vertex_attribute_t {
 	//! Data format of attribute
 	uint8_t format;
-	//! Binding identifier (used by backend)
+	//! Vertex buffer binding slot the attribute is fetched from
 	uint8_t binding;
 	//! Stride in bytes between consecutive elements of this attribute (0 means tightly packed)
 	uint16_t stride;
@@ -517,22 +744,36 @@ struct render_parameter_t {
 	unsigned int location;
 };
 
-#define RENDER_DECLARE_BUFFER        \
-	render_backend_t* backend;       \
-	RENDER_32BIT_PADDING(backendptr) \
-	uint8_t usage;                   \
-	uint8_t buffertype;              \
-	uint8_t policy;                  \
-	uint8_t flags;                   \
-	uint32_t locks;                  \
-	size_t allocated;                \
-	size_t used;                     \
-	size_t buffersize;               \
-	void* store;                     \
-	void* access;                    \
-	uintptr_t backend_data[4];       \
+#define RENDER_DECLARE_BUFFER         \
+	render_backend_t* backend;        \
+	RENDER_32BIT_PADDING(backendptr)  \
+	uint8_t usage;                    \
+	uint8_t buffertype;               \
+	uint8_t policy;                   \
+	uint8_t flags;                    \
+	uint32_t locks;                   \
+	uint32_t uploadpass;              \
+	size_t allocated;                 \
+	size_t used;                      \
+	size_t buffersize;                \
+	void* store;                      \
+	void* access;                     \
+	render_buffer_backing_t* backing; \
+	uintptr_t backend_data[4];        \
+	render_destroy_t destroy;         \
 	semaphore_t lock
 
+struct render_buffer_backing_t {
+	//! Resource the buffer data originates from, null if data is kept in spill cache
+	uuid_t source;
+	//! Offset of buffer data in resource static stream
+	size_t offset;
+	//! Spill cache holding compressed buffer data
+	void* spill;
+	//! Size of compressed spill cache data
+	size_t spill_size;
+};
+
 struct render_buffer_t {
 	RENDER_DECLARE_BUFFER;
 };
@@ -540,6 +781,8 @@ struct render_buffer_t {
 struct render_vertexbuffer_t {
 	RENDER_DECLARE_BUFFER;
 	render_vertex_decl_t decl;
+	//! Interned id of vertex declaration, 0 if declaration table is full
+	unsigned int decl_id;
 };
 
 struct render_indexbuffer_t {
@@ -547,8 +790,15 @@ struct render_indexbuffer_t {
 	render_index_format_t format;
 };
 
+struct render_palettebuffer_t {
+	RENDER_DECLARE_BUFFER;
+	//! Number of matrices reserved by appends since last reset
+	atomic32_t reserved;
+};
+
 #define RENDER_DECLARE_PARAMETERBUFFER(_parameter_count) \
 	RENDER_DECLARE_BUFFER;                               \
+	uint32_t generation;                                 \
 	unsigned int parameter_count;                        \
 	render_parameter_t parameters[_parameter_count]
 
@@ -569,6 +819,7 @@ struct render_statebuffer_t {
 	atomic32_t ref;                           \
 	uintptr_t backend_data[4];                \
 	RENDER_32BIT_PADDING_ARR(backend_data, 4) \
+	render_destroy_t destroy;                 \
 	uuid_t uuid
 
 FOUNDATION_ALIGNED_STRUCT(render_shader_t, 8) {
@@ -591,6 +842,7 @@ FOUNDATION_ALIGNED_STRUCT(render_program_t, 8) {
 	RENDER_32BIT_PADDING_ARR(pshaderptr)
 	uintptr_t backend_data[4];
 	RENDER_32BIT_PADDING_ARR(data, 4)
+	render_destroy_t destroy;
 	atomic32_t ref;
 	uint32_t size_parameterdata;
 	uint32_t num_parameters;
@@ -620,18 +872,162 @@ FOUNDATION_ALIGNED_STRUCT(render_program_t, 8) {
 	uint32_t __unused;                        \
 	uintptr_t backend_data[4];                \
 	RENDER_32BIT_PADDING_ARR(backend_data, 4) \
+	render_destroy_t destroy;                 \
 	uuid_t uuid
 
 FOUNDATION_ALIGNED_STRUCT(render_texture_t, 8) {
 	RENDER_DECLARE_TEXTURE;
 };
 
+//! State buffers derived from a source state buffer for a depth pre-pass
+struct render_pipeline_depth_state_t {
+	//! Source state buffer of opaque commands
+	render_statebuffer_t* source;
+	//! Source state the derived buffers were built from
+	render_state_t state;
+	//! Depth only state for the pre-pass, color writes disabled
+	render_statebuffer_t* depth;
+	//! State for the main pass, equal depth compare and depth writes disabled
+	render_statebuffer_t* equal;
+};
+
+struct render_scaling_t {
+	//! Native resolution, the size of the final image
+	unsigned int native_width;
+	unsigned int native_height;
+	//! Scaled resolution rendered to in the scaled targets
+	unsigned int width;
+	unsigned int height;
+	//! Current scale of the native resolution
+	real scale;
+	//! Bounds of the scale, scaled targets are sized for the maximum scale
+	real min_scale;
+	real max_scale;
+	//! Frame time in seconds the scale is adapted to meet
+	real target_time;
+	//! Relative deviation from the target frame time tolerated without changing scale
+	real tolerance;
+	//! Scale increase when frames are consistently faster than the target
+	real step;
+	//! Number of consecutive frames outside the tolerance before the scale is changed
+	unsigned int frames;
+	unsigned int frames_over;
+	unsigned int frames_under;
+	//! Pipeline frame + 1 of the last frame time sample taken from a pipeline
+	uint64_t sample_frame;
+	//! Targets rendered at the scaled resolution
+	render_target_t** targets;
+};
+
+struct render_pipeline_transient_t {
+	//! Target referenced by steps, sharing the backend storage of a pooled target
+	render_target_t target;
+	//! Index + 1 of the pooled target assigned when executed, zero if not used
+	size_t storage;
+	//! First and last position in dispatch order of steps using the target
+	size_t first;
+	size_t last;
+};
+
+struct render_pipeline_storage_t {
+	//! Pooled target holding the backend storage
+	render_target_t* target;
+	//! Last position in dispatch order of steps using the storage
+	size_t last;
+	//! Number of transient targets assigned the storage
+	unsigned int users;
+};
+
+struct render_pipeline_step_statistics_t {
+	//! Pipeline frame the statistics were recorded in
+	uint64_t frame;
+	//! Time spent in the executor, summed over partitions
+	tick_t executor_time;
+	//! Time spent merging and sorting the step contexts
+	tick_t sort_time;
+	//! Time spent dispatching the step to the backend, including derived pre-pass commands
+	tick_t dispatch_time;
+	//! GPU time in nanoseconds executing the step, collected some frames after dispatch
+	uint64_t gpu_time;
+	//! GPU timer of the step while the result is not yet available, zero once collected
+	unsigned int gpu_timer;
+	//! Number of commands dispatched by command type
+	unsigned int commands[RENDERCOMMAND_NUM];
+	//! Highest ratio of reserved to allocated commands of the step contexts
+	float32_t context_fill;
+	//! Set if the step was culled and neither recorded nor dispatched
+	bool culled;
+	//! Set if the dispatch was skipped as idle
+	bool skipped;
+};
+
+struct render_pipeline_statistics_t {
+	//! Pipeline frame the statistics were recorded in
+	uint64_t frame;
+	//! Time from start of execute to end of dispatch
+	tick_t time;
+	//! Time dispatch was blocked waiting for steps to be recorded by scheduler tasks
+	tick_t wait_time;
+	//! GPU time in nanoseconds executing all steps, collected some frames after dispatch
+	uint64_t gpu_time;
+	//! GPU timer of the frame while the result is not yet available, zero once collected
+	unsigned int gpu_timer;
+	//! Number of steps dispatched, skipped as idle and culled
+	unsigned int dispatched;
+	unsigned int skipped;
+	unsigned int culled;
+};
+
 struct render_pipeline_step_t {
 	render_backend_t* backend;
 	render_target_t* target;
 	atomic32_t* task_counter;
 	render_pipeline_execute_fn executor;
 	render_context_t** contexts;
+	//! Executor recording a range of work items to one context, null if not partitioned
+	render_pipeline_partition_fn partition_executor;
+	//! Number of partitions, each recorded by its own task to its own context
+	unsigned int partitions;
+	//! Number of work items distributed over partitions
+	size_t partition_work;
+	//! Next partition to record while executing
+	atomic32_t partition_next;
+	//! Number of partitions not yet recorded while executing
+	atomic32_t partition_pending;
+	//! Index of the first task of the step in the pipeline task array
+	size_t task_offset;
+	//! Index + 1 of the step a depth pre-pass is derived from, zero for other steps
+	size_t depth_source;
+	//! Position only program variant lookup for a depth pre-pass
+	render_pipeline_depth_program_fn depth_program;
+	//! Derived state buffers of a depth pre-pass
+	render_pipeline_depth_state_t* depth_state;
+	//! Target copied to the step target by a blit step, null for other steps
+	render_target_t* blit_source;
+	//! Resolution scaling of the blit source, null to copy the full source target
+	const render_scaling_t* blit_scaling;
+	//! Pipeline the step is executed by
+	render_pipeline_t* pipeline;
+	//! Targets sampled by the step
+	render_target_t** reads;
+	//! Targets rendered by the step, including the step target
+	render_target_t** writes;
+	//! Indices of steps depending on this step
+	size_t* dependents;
+	//! Number of steps this step depends on
+	unsigned int dependencies;
+	//! Number of dependencies not yet recorded while executing
+	atomic32_t pending;
+	//! Set if no pipeline output depends on the step, which is then neither recorded
+	//! nor dispatched
+	bool culled;
+	//! Recording state, set once all partitions are recorded
+	atomic32_t record_state;
+	//! Executor and sort time of the frame being recorded
+	atomic64_t executor_time;
+	tick_t sort_time;
+	//! Ring of statistics of the last frames, indexed by frame
+	render_pipeline_step_statistics_t statistics[RENDER_PIPELINE_STATISTICS_FRAMES];
 };
 
 struct render_pipeline_t {
@@ -641,6 +1037,22 @@ struct render_pipeline_t {
 	task_t* step_task;
 	task_arg_t* step_arg;
 	atomic32_t step_complete;
+	//! Targets used outside the pipeline, steps not contributing to them are culled
+	render_target_t** outputs;
+	//! Indices of steps not culled in dependency order
+	size_t* order;
+	//! Signaled by scheduler tasks when a step is recorded
+	semaphore_t recorded;
+	//! Transient targets, aliasing pooled targets when their lifetimes do not overlap
+	render_pipeline_transient_t** transients;
+	//! Pooled targets backing transient targets
+	render_pipeline_storage_t* storage;
+	//! Number of frames dispatched
+	uint64_t frame;
+	//! Start time of the frame being executed
+	tick_t frame_start;
+	//! Ring of statistics of the last frames, indexed by frame
+	render_pipeline_statistics_t statistics[RENDER_PIPELINE_STATISTICS_FRAMES];
 };
 
 struct render_resolution_t {
@@ -655,4 +1067,6 @@ struct render_resolution_t {
 struct render_vertex_decl_element_t {
 	render_vertex_format_t format;
 	render_vertex_attribute_id attribute;
+	//! Vertex buffer binding slot the attribute is fetched from
+	unsigned int binding;
 };
@@ -25,8 +25,8 @@ render_vertexbuffer_t*
 render_vertexbuffer_allocate(render_backend_t* backend, render_usage_t usage, size_t num_vertices,
                              size_t buffer_size, const render_vertex_decl_t* decl, const void* data,
                              size_t data_size) {
-	render_vertexbuffer_t* buffer = memory_allocate(HASH_RENDER, sizeof(render_vertexbuffer_t), 0,
-	                                                MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	render_vertexbuffer_t* buffer =
+	    render_pool_allocate(&_render_buffer_pool, sizeof(render_vertexbuffer_t));
 	buffer->backend = backend;
 	buffer->usage = (uint8_t)usage;
 	buffer->buffertype = RENDERBUFFER_VERTEX;
@@ -34,6 +34,7 @@ render_vertexbuffer_allocate(render_backend_t* backend, render_usage_t usage, si
 	buffer->buffersize = buffer_size;
 	semaphore_initialize(&buffer->lock, 1);
 	memcpy(&buffer->decl, decl, sizeof(render_vertex_decl_t));
+	buffer->decl_id = render_vertex_decl_intern(decl);
 	memset(buffer->backend_data, 0, sizeof(buffer->backend_data));
 
 	if (num_vertices) {
@@ -73,19 +74,17 @@ render_vertexbuffer_upload(render_vertexbuffer_t* buffer) {
 
 void
 render_vertexbuffer_free(render_vertexbuffer_t* buffer, bool sys, bool aux) {
-	buffer->backend->vtable.deallocate_buffer(buffer->backend, (render_buffer_t*)buffer, sys, aux);
+	render_buffer_free((render_buffer_t*)buffer, sys, aux);
 }
 
 void
-render_vertexbuffer_restore(render_vertexbuffer_t* buffer) {
-	buffer->backend->vtable.allocate_buffer(buffer->backend, (render_buffer_t*)buffer);
-
-	//...
-	// All loadable resources should have a stream identifier, an offset and a size
-	// to be able to repoen the stream and read the raw buffer back
-	//...
+render_vertexbuffer_set_discard(render_vertexbuffer_t* buffer, const uuid_t source, size_t offset) {
+	render_buffer_set_discard((render_buffer_t*)buffer, source, offset);
+}
 
-	buffer->flags |= RENDERBUFFER_DIRTY;
+void
+render_vertexbuffer_restore(render_vertexbuffer_t* buffer) {
+	render_buffer_restore((render_buffer_t*)buffer);
 }
 
 static const uint16_t _vertex_format_size[VERTEXFORMAT_NUMTYPES + 1] = {
@@ -106,6 +105,16 @@ static const uint16_t _vertex_format_size[VERTEXFORMAT_NUMTYPES + 1] = {
     8,   // VERTEXFORMAT_INT2
     16,  // VERTEXFORMAT_INT4
 
+    4,  // VERTEXFORMAT_HALF2
+    8,  // VERTEXFORMAT_HALF4
+
+    4,  // VERTEXFORMAT_SHORT2_SNORM
+    8,  // VERTEXFORMAT_SHORT4_SNORM
+    4,  // VERTEXFORMAT_USHORT2_UNORM
+    8,  // VERTEXFORMAT_USHORT4_UNORM
+
+    4,  // VERTEXFORMAT_INT1010102_SNORM
+
     0};
 
 uint16_t
@@ -126,6 +135,94 @@ render_vertex_decl_calculate_size(const render_vertex_decl_t* decl) {
 	return size;
 }
 
+static render_vertex_decl_t* _render_vertex_decl_table;
+static hash_t* _render_vertex_decl_hash;
+static atomic32_t _render_vertex_decl_count;
+static mutex_t* _render_vertex_decl_lock;
+
+int
+render_vertex_decl_table_initialize(void) {
+	_render_vertex_decl_table = memory_allocate(
+	    HASH_RENDER, sizeof(render_vertex_decl_t) * _render_config.vertex_decl_max, 0,
+	    MEMORY_PERSISTENT);
+	_render_vertex_decl_hash = memory_allocate(
+	    HASH_RENDER, sizeof(hash_t) * _render_config.vertex_decl_max, 0, MEMORY_PERSISTENT);
+	_render_vertex_decl_lock = mutex_allocate(STRING_CONST("render_vertex_decl"));
+	atomic_store32(&_render_vertex_decl_count, 0, memory_order_release);
+	return 0;
+}
+
+void
+render_vertex_decl_table_finalize(void) {
+	mutex_deallocate(_render_vertex_decl_lock);
+	memory_deallocate(_render_vertex_decl_hash);
+	memory_deallocate(_render_vertex_decl_table);
+	_render_vertex_decl_lock = nullptr;
+	_render_vertex_decl_hash = nullptr;
+	_render_vertex_decl_table = nullptr;
+}
+
+static unsigned int
+render_vertex_decl_find(const render_vertex_decl_t* decl, hash_t declhash, int32_t count) {
+	for (int32_t idecl = 0; idecl < count; ++idecl) {
+		if ((_render_vertex_decl_hash[idecl] == declhash) &&
+		    !memcmp(_render_vertex_decl_table + idecl, decl, sizeof(render_vertex_decl_t)))
+			return (unsigned int)idecl + 1;
+	}
+	return 0;
+}
+
+unsigned int
+render_vertex_decl_intern(const render_vertex_decl_t* decl) {
+	// Entries are never modified once published, lookups only need the lock to insert
+	hash_t declhash = hash(decl, sizeof(render_vertex_decl_t));
+	int32_t count = atomic_load32(&_render_vertex_decl_count, memory_order_acquire);
+	unsigned int id = render_vertex_decl_find(decl, declhash, count);
+	if (id)
+		return id;
+
+	mutex_lock(_render_vertex_decl_lock);
+	count = atomic_load32(&_render_vertex_decl_count, memory_order_acquire);
+	id = render_vertex_decl_find(decl, declhash, count);
+	if (!id) {
+		if ((size_t)count < _render_config.vertex_decl_max) {
+			memcpy(_render_vertex_decl_table + count, decl, sizeof(render_vertex_decl_t));
+			_render_vertex_decl_hash[count] = declhash;
+			atomic_store32(&_render_vertex_decl_count, count + 1, memory_order_release);
+			id = (unsigned int)count + 1;
+		} else {
+			log_warn(HASH_RENDER, WARNING_RESOURCE,
+			         STRING_CONST("Vertex declaration table full, increase vertex_decl_max"));
+		}
+	}
+	mutex_unlock(_render_vertex_decl_lock);
+
+	return id;
+}
+
+const render_vertex_decl_t*
+render_vertex_decl_lookup(unsigned int id) {
+	if (!id || (id > (unsigned int)atomic_load32(&_render_vertex_decl_count, memory_order_acquire)))
+		return nullptr;
+	return _render_vertex_decl_table + (id - 1);
+}
+
+size_t
+render_vertex_decl_binding_stride(const render_vertex_decl_t* decl, unsigned int binding) {
+	size_t size = 0;
+	for (unsigned int i = 0; i < RENDER_MAX_ATTRIBUTES; ++i) {
+		if ((decl->attribute[i].format >= VERTEXFORMAT_NUMTYPES) ||
+		    (decl->attribute[i].binding != binding))
+			continue;
+		if (decl->attribute[i].stride)
+			return decl->attribute[i].stride;
+		size_t end = decl->attribute[i].offset + _vertex_format_size[decl->attribute[i].format];
+		if (end > size)
+			size = end;
+	}
+	return size;
+}
+
 render_vertex_decl_t*
 render_vertex_decl_allocate(render_vertex_decl_element_t* elements, size_t num_elements) {
 	render_vertex_decl_t* decl =
@@ -159,22 +256,24 @@ void
 render_vertex_decl_initialize(render_vertex_decl_t* decl, render_vertex_decl_element_t* elements,
                               size_t num_elements) {
 	size_t i;
-	unsigned int offset = 0;
+	unsigned int offset[RENDER_MAX_VERTEX_BINDINGS] = {0};
 	memset(decl, 0, sizeof(render_vertex_decl_t));
 	for (i = 0; i < RENDER_MAX_ATTRIBUTES; ++i)
 		decl->attribute[i].format = VERTEXFORMAT_UNUSED;
 
 	for (i = 0; i < num_elements; ++i) {
-		if (elements[i].attribute < RENDER_MAX_ATTRIBUTES) {
+		unsigned int binding = elements[i].binding;
+		if ((elements[i].attribute < RENDER_MAX_ATTRIBUTES) &&
+		    FOUNDATION_VALIDATE_MSG(binding < RENDER_MAX_VERTEX_BINDINGS, "Invalid vertex binding")) {
 			decl->attribute[elements[i].attribute].format = (uint8_t)elements[i].format;
-			decl->attribute[elements[i].attribute].binding = 0;
-			decl->attribute[elements[i].attribute].offset = (uint16_t)offset;
-			offset += _vertex_format_size[elements[i].format];
+			decl->attribute[elements[i].attribute].binding = (uint8_t)binding;
+			decl->attribute[elements[i].attribute].offset = (uint16_t)offset[binding];
+			offset[binding] += _vertex_format_size[elements[i].format];
 		}
 	}
 
 	for (i = 0; i < RENDER_MAX_ATTRIBUTES; ++i)
-		decl->attribute[i].stride = (uint16_t)offset;
+		decl->attribute[i].stride = (uint16_t)offset[decl->attribute[i].binding];
 }
 
 void
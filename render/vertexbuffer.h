@@ -103,6 +103,25 @@ render_vertex_decl_deallocate(render_vertex_decl_t* decl);
 RENDER_API size_t
 render_vertex_decl_calculate_size(const render_vertex_decl_t* decl);
 
+/*! Intern a vertex declaration, identical declarations map to the same id. Ids are
+small integers suitable for sort keys and backend layout caches
+\param decl Vertex declaration
+\return Declaration id, 0 if declaration table is full */
+RENDER_API unsigned int
+render_vertex_decl_intern(const render_vertex_decl_t* decl);
+
+/*! Get interned vertex declaration
+\param id Declaration id
+\return Vertex declaration, null if invalid id */
+RENDER_API const render_vertex_decl_t*
+render_vertex_decl_lookup(unsigned int id);
+
+/*! Get stride between consecutive vertices in the given binding slot
+\param decl Vertex declaration
+\param binding Binding slot
+\return Vertex stride in bytes, 0 if no attributes in binding */
+RENDER_API size_t
+render_vertex_decl_binding_stride(const render_vertex_decl_t* decl, unsigned int binding);
 
 RENDER_API render_vertexbuffer_t*
 render_vertexbuffer_allocate(render_backend_t* backend, render_usage_t usage, size_t num_vertices,
@@ -124,5 +143,15 @@ render_vertexbuffer_upload(render_vertexbuffer_t* buffer);
 RENDER_API void
 render_vertexbuffer_free(render_vertexbuffer_t* buffer, bool sys, bool aux);
 
+/*! Opt-in to drop the system memory store of a static buffer after upload. The data is
+restored on demand from the given resource static stream, or from a compressed spill
+cache if source is a null uuid, when the buffer is locked or restored after context loss.
+Data without source that does not compress keeps its store, since a raw copy saves nothing
+\param buffer Buffer
+\param source Resource the buffer data originates from, null uuid to use spill cache
+\param offset Offset of buffer data in resource static stream */
+RENDER_API void
+render_vertexbuffer_set_discard(render_vertexbuffer_t* buffer, const uuid_t source, size_t offset);
+
 RENDER_API void
 render_vertexbuffer_restore(render_vertexbuffer_t* buffer);
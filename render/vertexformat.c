@@ -0,0 +1,492 @@
+/* vertexformat.c  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+
+#include <render/render.h>
+
+#if FOUNDATION_ARCH_SSE2
+#include <emmintrin.h>
+#elif FOUNDATION_ARCH_NEON
+#include <arm_neon.h>
+#endif
+
+static const uint8_t _vertex_format_components[VERTEXFORMAT_NUMTYPES] = {
+    1, 2, 3, 4,  // VERTEXFORMAT_FLOAT*
+    4, 4,        // VERTEXFORMAT_UBYTE4_*
+    1, 2, 4,     // VERTEXFORMAT_SHORT*
+    1, 2, 4,     // VERTEXFORMAT_INT*
+    2, 4,        // VERTEXFORMAT_HALF*
+    2, 4, 2, 4,  // VERTEXFORMAT_[U]SHORT*_[S|U]NORM
+    4            // VERTEXFORMAT_INT1010102_SNORM
+};
+
+unsigned int
+render_vertex_format_components(render_vertex_format_t format) {
+	return (format < VERTEXFORMAT_NUMTYPES) ? _vertex_format_components[format] : 0;
+}
+
+static void
+render_vertex_load(float* value, const void* source, unsigned int components) {
+	value[0] = value[1] = value[2] = value[3] = 0;
+	memcpy(value, source, sizeof(float) * components);
+}
+
+static float
+render_vertex_clamp(float value, float low, float high) {
+	return (value < low) ? low : ((value > high) ? high : value);
+}
+
+static int32_t
+render_vertex_round(float value) {
+	return (int32_t)(value + ((value < 0.0f) ? -0.5f : 0.5f));
+}
+
+static uint16_t
+render_vertex_half(float value) {
+	// Round to nearest even, overflow to infinity and keep NaN
+	uint32_t bits;
+	uint16_t half;
+	memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = bits & 0x80000000U;
+	bits ^= sign;
+	if (bits >= 0x47800000U) {
+		half = (bits > 0x7F800000U) ? 0x7E00 : 0x7C00;
+	} else if (bits < 0x38800000U) {
+		// Subnormal result, use magic add to align and round mantissa
+		const uint32_t magic_bits = ((127 - 15) + (23 - 10) + 1) << 23;
+		float magic;
+		memcpy(&magic, &magic_bits, sizeof(magic));
+		memcpy(&value, &bits, sizeof(value));
+		value += magic;
+		memcpy(&bits, &value, sizeof(bits));
+		half = (uint16_t)(bits - magic_bits);
+	} else {
+		uint32_t odd = (bits >> 13) & 1;
+		bits += ((uint32_t)(15 - 127) << 23) + 0xFFF + odd;
+		half = (uint16_t)(bits >> 13);
+	}
+	return (uint16_t)(half | (sign >> 16));
+}
+
+static uint32_t
+render_vertex_pack1010102(int32_t x, int32_t y, int32_t z, int32_t w) {
+	return ((uint32_t)x & 0x3FF) | (((uint32_t)y & 0x3FF) << 10) | (((uint32_t)z & 0x3FF) << 20) |
+	       ((uint32_t)w << 30);
+}
+
+static void
+render_vertex_convert_scalar(render_vertex_format_t format, uint8_t* dst, size_t dst_stride,
+                             const uint8_t* src, size_t src_stride, unsigned int src_components,
+                             size_t count) {
+	const unsigned int components = _vertex_format_components[format];
+	for (size_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+		float value[4];
+		render_vertex_load(value, src, src_components);
+		switch (format) {
+			case VERTEXFORMAT_FLOAT:
+			case VERTEXFORMAT_FLOAT2:
+			case VERTEXFORMAT_FLOAT3:
+			case VERTEXFORMAT_FLOAT4:
+				memcpy(dst, value, sizeof(float) * components);
+				break;
+
+			case VERTEXFORMAT_UBYTE4_UNORM:
+				for (unsigned int ic = 0; ic < 4; ++ic)
+					dst[ic] = (uint8_t)render_vertex_round(render_vertex_clamp(value[ic], 0, 1) * 255.0f);
+				break;
+
+			case VERTEXFORMAT_UBYTE4_SNORM:
+				for (unsigned int ic = 0; ic < 4; ++ic)
+					dst[ic] =
+					    (uint8_t)(int8_t)render_vertex_round(render_vertex_clamp(value[ic], -1, 1) * 127.0f);
+				break;
+
+			case VERTEXFORMAT_SHORT:
+			case VERTEXFORMAT_SHORT2:
+			case VERTEXFORMAT_SHORT4:
+				for (unsigned int ic = 0; ic < components; ++ic) {
+					int16_t element =
+					    (int16_t)render_vertex_round(render_vertex_clamp(value[ic], -32768.0f, 32767.0f));
+					memcpy(dst + (ic * sizeof(int16_t)), &element, sizeof(int16_t));
+				}
+				break;
+
+			case VERTEXFORMAT_INT:
+			case VERTEXFORMAT_INT2:
+			case VERTEXFORMAT_INT4:
+				for (unsigned int ic = 0; ic < components; ++ic) {
+					int32_t element = render_vertex_round(
+					    render_vertex_clamp(value[ic], -2147483648.0f, 2147483520.0f));
+					memcpy(dst + (ic * sizeof(int32_t)), &element, sizeof(int32_t));
+				}
+				break;
+
+			case VERTEXFORMAT_HALF2:
+			case VERTEXFORMAT_HALF4:
+				for (unsigned int ic = 0; ic < components; ++ic) {
+					uint16_t element = render_vertex_half(value[ic]);
+					memcpy(dst + (ic * sizeof(uint16_t)), &element, sizeof(uint16_t));
+				}
+				break;
+
+			case VERTEXFORMAT_SHORT2_SNORM:
+			case VERTEXFORMAT_SHORT4_SNORM:
+				for (unsigned int ic = 0; ic < components; ++ic) {
+					int16_t element =
+					    (int16_t)render_vertex_round(render_vertex_clamp(value[ic], -1, 1) * 32767.0f);
+					memcpy(dst + (ic * sizeof(int16_t)), &element, sizeof(int16_t));
+				}
+				break;
+
+			case VERTEXFORMAT_USHORT2_UNORM:
+			case VERTEXFORMAT_USHORT4_UNORM:
+				for (unsigned int ic = 0; ic < components; ++ic) {
+					uint16_t element =
+					    (uint16_t)render_vertex_round(render_vertex_clamp(value[ic], 0, 1) * 65535.0f);
+					memcpy(dst + (ic * sizeof(uint16_t)), &element, sizeof(uint16_t));
+				}
+				break;
+
+			case VERTEXFORMAT_INT1010102_SNORM: {
+				uint32_t element = render_vertex_pack1010102(
+				    render_vertex_round(render_vertex_clamp(value[0], -1, 1) * 511.0f),
+				    render_vertex_round(render_vertex_clamp(value[1], -1, 1) * 511.0f),
+				    render_vertex_round(render_vertex_clamp(value[2], -1, 1) * 511.0f),
+				    render_vertex_round(render_vertex_clamp(value[3], -1, 1)));
+				memcpy(dst, &element, sizeof(uint32_t));
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+}
+
+#if FOUNDATION_ARCH_SSE2
+
+static __m128i
+render_vertex_half_sse2(__m128 value) {
+	// Vectorized version of render_vertex_half
+	const __m128i c_sign = _mm_set1_epi32((int)0x80000000U);
+	const __m128i c_max = _mm_set1_epi32((127 + 16) << 23);
+	const __m128i c_nan = _mm_set1_epi32(0x200);
+	const __m128i c_infinity = _mm_set1_epi32(0x7C00);
+	const __m128i c_min_normal = _mm_set1_epi32((127 - 14) << 23);
+	const __m128i c_subnormal_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	const __m128i c_normal_bias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+	__m128 sign = _mm_and_ps(_mm_castsi128_ps(c_sign), value);
+	__m128 absvalue = _mm_xor_ps(value, sign);
+	__m128i absbits = _mm_castps_si128(absvalue);
+	__m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(absvalue, absvalue));
+	__m128i is_regular = _mm_cmpgt_epi32(c_max, absbits);
+	__m128i special = _mm_or_si128(_mm_and_si128(is_nan, c_nan), c_infinity);
+	__m128i is_subnormal = _mm_cmpgt_epi32(c_min_normal, absbits);
+
+	__m128 subnormal_add = _mm_add_ps(absvalue, _mm_castsi128_ps(c_subnormal_magic));
+	__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(subnormal_add), c_subnormal_magic);
+
+	__m128i odd = _mm_srai_epi32(_mm_slli_epi32(absbits, 31 - 13), 31);
+	__m128i normal =
+	    _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absbits, c_normal_bias), odd), 13);
+
+	__m128i regular = _mm_or_si128(_mm_and_si128(subnormal, is_subnormal),
+	                               _mm_andnot_si128(is_subnormal, normal));
+	__m128i result =
+	    _mm_or_si128(_mm_and_si128(regular, is_regular), _mm_andnot_si128(is_regular, special));
+	return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+}
+
+static __m128i
+render_vertex_quantize_sse2(__m128 value, __m128 low, __m128 high, __m128 scale) {
+	__m128 scaled = _mm_mul_ps(_mm_min_ps(_mm_max_ps(value, low), high), scale);
+	// Conversion rounds half to even, truncate after adding half with the sign of the value
+	// to round half away from zero to match scalar path
+	__m128 sign = _mm_and_ps(scaled, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000U)));
+	__m128 bias = _mm_or_ps(sign, _mm_set1_ps(0.5f));
+	return _mm_cvttps_epi32(_mm_add_ps(scaled, bias));
+}
+
+static void
+render_vertex_convert_simd(render_vertex_format_t format, uint8_t* dst, size_t dst_stride,
+                           const uint8_t* src, size_t src_stride, unsigned int src_components,
+                           size_t count) {
+	const size_t size = render_vertex_attribute_size(format);
+	const __m128i zeroi = _mm_setzero_si128();
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 negone = _mm_set1_ps(-1.0f);
+	const __m128 snorm_scale = _mm_set1_ps(32767.0f);
+	const __m128 unorm_scale = _mm_set1_ps(65535.0f);
+	const __m128 packed_scale = _mm_set_ps(1.0f, 511.0f, 511.0f, 511.0f);
+	const __m128i unorm_bias = _mm_set1_epi32(32768);
+	const __m128i unorm_flip = _mm_set1_epi16((short)0x8000);
+
+	for (size_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+		__m128 value;
+		if (src_components == 4) {
+			value = _mm_loadu_ps((const float*)src);
+		} else {
+			float element[4];
+			render_vertex_load(element, src, src_components);
+			value = _mm_loadu_ps(element);
+		}
+
+		__m128i result;
+		switch (format) {
+			case VERTEXFORMAT_HALF2:
+			case VERTEXFORMAT_HALF4:
+				result = _mm_packs_epi32(render_vertex_half_sse2(value), zeroi);
+				break;
+
+			case VERTEXFORMAT_SHORT2_SNORM:
+			case VERTEXFORMAT_SHORT4_SNORM:
+				result = _mm_packs_epi32(
+				    render_vertex_quantize_sse2(value, negone, one, snorm_scale), zeroi);
+				break;
+
+			case VERTEXFORMAT_USHORT2_UNORM:
+			case VERTEXFORMAT_USHORT4_UNORM:
+				// No unsigned saturating pack in SSE2, bias into signed range and flip back
+				result = _mm_xor_si128(
+				    _mm_packs_epi32(
+				        _mm_sub_epi32(render_vertex_quantize_sse2(value, zero, one, unorm_scale),
+				                      unorm_bias),
+				        zeroi),
+				    unorm_flip);
+				break;
+
+			default: {
+				int32_t lane[4];
+				_mm_storeu_si128((__m128i*)lane,
+				                 render_vertex_quantize_sse2(value, negone, one, packed_scale));
+				result = _mm_cvtsi32_si128(
+				    (int)render_vertex_pack1010102(lane[0], lane[1], lane[2], lane[3]));
+				break;
+			}
+		}
+
+		uint8_t out[16];
+		_mm_storeu_si128((__m128i*)out, result);
+		memcpy(dst, out, size);
+	}
+}
+
+#elif FOUNDATION_ARCH_NEON
+
+static int32x4_t
+render_vertex_quantize_neon(float32x4_t value, float32x4_t low, float32x4_t high,
+                            float32x4_t scale) {
+	float32x4_t scaled = vmulq_f32(vminq_f32(vmaxq_f32(value, low), high), scale);
+	// Conversion truncates, round half away from zero to match scalar path
+	uint32x4_t negative = vcltq_f32(scaled, vdupq_n_f32(0.0f));
+	float32x4_t bias = vbslq_f32(negative, vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+	return vcvtq_s32_f32(vaddq_f32(scaled, bias));
+}
+
+static void
+render_vertex_convert_simd(render_vertex_format_t format, uint8_t* dst, size_t dst_stride,
+                           const uint8_t* src, size_t src_stride, unsigned int src_components,
+                           size_t count) {
+	const size_t size = render_vertex_attribute_size(format);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t negone = vdupq_n_f32(-1.0f);
+	const float32x4_t snorm_scale = vdupq_n_f32(32767.0f);
+	const float32x4_t unorm_scale = vdupq_n_f32(65535.0f);
+	const float packed_scale_array[4] = {511.0f, 511.0f, 511.0f, 1.0f};
+	const float32x4_t packed_scale = vld1q_f32(packed_scale_array);
+
+	for (size_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+		float element[4];
+		float32x4_t value;
+		if (src_components == 4) {
+			memcpy(element, src, sizeof(element));
+		} else {
+			render_vertex_load(element, src, src_components);
+		}
+		value = vld1q_f32(element);
+
+		uint16_t out[4];
+		switch (format) {
+			case VERTEXFORMAT_HALF2:
+			case VERTEXFORMAT_HALF4:
+#if FOUNDATION_ARCH_ARM_64
+				vst1_u16(out, vreinterpret_u16_f16(vcvt_f16_f32(value)));
+#else
+				for (unsigned int ic = 0; ic < 4; ++ic)
+					out[ic] = render_vertex_half(element[ic]);
+#endif
+				break;
+
+			case VERTEXFORMAT_SHORT2_SNORM:
+			case VERTEXFORMAT_SHORT4_SNORM:
+				vst1_u16(out, vreinterpret_u16_s16(vqmovn_s32(
+				                  render_vertex_quantize_neon(value, negone, one, snorm_scale))));
+				break;
+
+			case VERTEXFORMAT_USHORT2_UNORM:
+			case VERTEXFORMAT_USHORT4_UNORM:
+				vst1_u16(out, vqmovun_s32(render_vertex_quantize_neon(value, zero, one, unorm_scale)));
+				break;
+
+			default: {
+				int32_t lane[4];
+				vst1q_s32(lane, render_vertex_quantize_neon(value, negone, one, packed_scale));
+				uint32_t packed = render_vertex_pack1010102(lane[0], lane[1], lane[2], lane[3]);
+				memcpy(out, &packed, sizeof(packed));
+				break;
+			}
+		}
+
+		memcpy(dst, out, size);
+	}
+}
+
+#endif
+
+bool
+render_vertex_convert(render_vertex_format_t format, void* destination, size_t destination_stride,
+                      const float* source, size_t source_stride, unsigned int source_components,
+                      size_t count) {
+	if ((format >= VERTEXFORMAT_NUMTYPES) || !source_components || (source_components > 4))
+		return false;
+
+	uint8_t* dst = destination;
+	const uint8_t* src = (const uint8_t*)source;
+	switch (format) {
+		case VERTEXFORMAT_HALF2:
+		case VERTEXFORMAT_HALF4:
+		case VERTEXFORMAT_SHORT2_SNORM:
+		case VERTEXFORMAT_SHORT4_SNORM:
+		case VERTEXFORMAT_USHORT2_UNORM:
+		case VERTEXFORMAT_USHORT4_UNORM:
+		case VERTEXFORMAT_INT1010102_SNORM:
+#if FOUNDATION_ARCH_SSE2 || FOUNDATION_ARCH_NEON
+			render_vertex_convert_simd(format, dst, destination_stride, src, source_stride,
+			                           source_components, count);
+			break;
+#endif
+		default:
+			render_vertex_convert_scalar(format, dst, destination_stride, src, source_stride,
+			                             source_components, count);
+			break;
+	}
+	return true;
+}
+
+bool
+render_vertex_decl_convert(const render_vertex_decl_t* decl, void* destination,
+                           const render_vertex_decl_t* source_decl, const void* source,
+                           size_t num_vertices) {
+	for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
+		const render_vertex_attribute_t* attribute = decl->attribute + attrib;
+		const render_vertex_attribute_t* source_attribute = source_decl->attribute + attrib;
+		if (attribute->format >= VERTEXFORMAT_NUMTYPES)
+			continue;
+		if (source_attribute->format >= VERTEXFORMAT_NUMTYPES) {
+			log_warnf(HASH_RENDER, WARNING_INVALID_VALUE,
+			          STRING_CONST("Vertex attribute %u missing in source declaration"), attrib);
+			return false;
+		}
+
+		const render_vertex_format_t format = (render_vertex_format_t)attribute->format;
+		const render_vertex_format_t source_format = (render_vertex_format_t)source_attribute->format;
+		const size_t size = render_vertex_attribute_size(format);
+		const size_t stride = attribute->stride ? attribute->stride : size;
+		const size_t source_stride = source_attribute->stride ?
+		                                 source_attribute->stride :
+		                                 render_vertex_attribute_size(source_format);
+		uint8_t* dst = pointer_offset(destination, attribute->offset);
+		const uint8_t* src = pointer_offset_const(source, source_attribute->offset);
+
+		if (format == source_format) {
+			for (size_t ivertex = 0; ivertex < num_vertices;
+			     ++ivertex, dst += stride, src += source_stride)
+				memcpy(dst, src, size);
+		} else if (source_format <= VERTEXFORMAT_FLOAT4) {
+			render_vertex_convert(format, dst, stride, (const float*)src, source_stride,
+			                      _vertex_format_components[source_format], num_vertices);
+		} else {
+			log_warnf(HASH_RENDER, WARNING_INVALID_VALUE,
+			          STRING_CONST("Vertex attribute %u source format is not float"), attrib);
+			return false;
+		}
+	}
+	return true;
+}
+
+static render_vertex_format_t
+render_vertex_quantized_format(unsigned int attribute, render_vertex_format_t format) {
+	const unsigned int components = _vertex_format_components[format];
+	switch (attribute) {
+		case VERTEXATTRIBUTE_NORMAL:
+		case VERTEXATTRIBUTE_TANGENT:
+		case VERTEXATTRIBUTE_BINORMAL:
+			if (components >= 3)
+				return VERTEXFORMAT_INT1010102_SNORM;
+			return (components == 2) ? VERTEXFORMAT_SHORT2_SNORM : format;
+
+		case VERTEXATTRIBUTE_PRIMARYCOLOR:
+		case VERTEXATTRIBUTE_SECONDARYCOLOR:
+			// Missing components convert to zero, only quantize colors with alpha
+			return (components == 4) ? VERTEXFORMAT_UBYTE4_UNORM : format;
+
+		case VERTEXATTRIBUTE_WEIGHT:
+			if (components >= 3)
+				return VERTEXFORMAT_USHORT4_UNORM;
+			return (components == 2) ? VERTEXFORMAT_USHORT2_UNORM : format;
+
+		default:
+			if ((attribute >= VERTEXATTRIBUTE_TEXCOORD0) && (attribute < VERTEXATTRIBUTE_TANGENT)) {
+				if (components >= 3)
+					return VERTEXFORMAT_HALF4;
+				return (components == 2) ? VERTEXFORMAT_HALF2 : format;
+			}
+			break;
+	}
+	return format;
+}
+
+bool
+render_vertex_decl_quantize(render_vertex_decl_t* decl, const render_vertex_decl_t* source_decl) {
+	unsigned int offset[RENDER_MAX_VERTEX_BINDINGS] = {0};
+	bool quantized = false;
+	memcpy(decl, source_decl, sizeof(render_vertex_decl_t));
+	for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
+		render_vertex_attribute_t* attribute = decl->attribute + attrib;
+		if ((attribute->format >= VERTEXFORMAT_NUMTYPES) ||
+		    (attribute->binding >= RENDER_MAX_VERTEX_BINDINGS))
+			continue;
+		render_vertex_format_t format = (render_vertex_format_t)attribute->format;
+		if (format <= VERTEXFORMAT_FLOAT4)
+			format = render_vertex_quantized_format(attrib, format);
+		quantized |= (format != attribute->format);
+		attribute->format = (uint8_t)format;
+		attribute->offset = offset[attribute->binding];
+		offset[attribute->binding] += render_vertex_attribute_size(format);
+	}
+	for (unsigned int attrib = 0; attrib < RENDER_MAX_ATTRIBUTES; ++attrib) {
+		render_vertex_attribute_t* attribute = decl->attribute + attrib;
+		if (attribute->binding < RENDER_MAX_VERTEX_BINDINGS)
+			attribute->stride = (uint16_t)offset[attribute->binding];
+	}
+	return quantized;
+}
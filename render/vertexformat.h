@@ -0,0 +1,73 @@
+/* vertexformat.h  -  Render library  -  Public Domain  -  2017 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform rendering library in C11 providing
+ * basic 2D/3D rendering functionality for projects based on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/render_lib
+ *
+ * The dependent library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file vertexformat.h
+    Conversion of float vertex attribute streams to quantized vertex formats */
+
+#include <foundation/platform.h>
+
+#include <render/types.h>
+
+/*! Get number of components in vertex attribute format
+\param format Vertex attribute format
+\return Number of components, 0 if invalid format */
+RENDER_API unsigned int
+render_vertex_format_components(render_vertex_format_t format);
+
+/*! Convert a stream of float vertex attributes to the given format. Components missing
+in source are set to zero. Float values are clamped to the range of normalized formats.
+\param format Destination vertex attribute format
+\param destination Destination of first element
+\param destination_stride Stride in bytes between destination elements
+\param source Source of first element
+\param source_stride Stride in bytes between source elements
+\param source_components Number of float components in each source element (1-4)
+\param count Number of elements to convert
+\return true if converted, false if format is not a valid conversion target */
+RENDER_API bool
+render_vertex_convert(render_vertex_format_t format, void* destination, size_t destination_stride,
+                      const float* source, size_t source_stride, unsigned int source_components,
+                      size_t count);
+
+/*! Convert vertex data between declarations. Every attribute used in the destination
+declaration must be declared with a float format in the source declaration, or with the
+same format in which case it is copied.
+\param decl Destination vertex declaration
+\param destination Destination vertex data
+\param source_decl Source vertex declaration
+\param source Source vertex data
+\param num_vertices Number of vertices
+\return true if converted, false if declarations are incompatible */
+RENDER_API bool
+render_vertex_decl_convert(const render_vertex_decl_t* decl, void* destination,
+                           const render_vertex_decl_t* source_decl, const void* source,
+                           size_t num_vertices);
+
+/*! Build the quantized counterpart of a vertex declaration. Float normals, tangents and
+binormals map to 10:10:10:2 or 16-bit signed normalized, colors with four components to
+8-bit unsigned normalized, weights to 16-bit unsigned normalized and texture coordinates to
+half floats. Positions and attributes already in other formats are kept. Attributes are
+laid out interleaved per binding in attribute order, data can then be converted with
+render_vertex_decl_convert
+\param decl Receives quantized vertex declaration
+\param source_decl Source vertex declaration
+\return true if any attribute was quantized, false if declaration is unchanged */
+RENDER_API bool
+render_vertex_decl_quantize(render_vertex_decl_t* decl, const render_vertex_decl_t* source_decl);
@@ -478,12 +478,842 @@ DECLARE_TEST(render, gles2_box) {
 
 #endif
 
+DECLARE_TEST(render, buffer_spill) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_vertex_decl_t decl;
+	render_vertex_decl_initialize_varg(&decl, VERTEXFORMAT_FLOAT4, VERTEXATTRIBUTE_POSITION,
+	                                   VERTEXFORMAT_UNKNOWN);
+
+	// Repeating pattern compresses, random data does not
+	float32_t vertexdata[256 * 4];
+	for (size_t ivert = 0; ivert < 256; ++ivert) {
+		vertexdata[(ivert * 4) + 0] = (float32_t)(ivert % 7);
+		vertexdata[(ivert * 4) + 1] = (float32_t)(ivert % 3);
+		vertexdata[(ivert * 4) + 2] = 0.5f;
+		vertexdata[(ivert * 4) + 3] = 1.0f;
+	}
+	uint32_t randomdata[256 * 4];
+	for (size_t ival = 0; ival < 256 * 4; ++ival)
+		randomdata[ival] = random32();
+
+	render_vertexbuffer_t* vertexbuffer =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 256, sizeof(vertexdata), &decl,
+	                                 vertexdata, sizeof(vertexdata));
+	render_vertexbuffer_t* randombuffer =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 256, sizeof(randomdata), &decl,
+	                                 randomdata, sizeof(randomdata));
+	render_vertexbuffer_set_discard(vertexbuffer, uuid_null(), 0);
+	render_vertexbuffer_set_discard(randombuffer, uuid_null(), 0);
+
+	render_vertexbuffer_upload(vertexbuffer);
+	render_vertexbuffer_upload(randombuffer);
+
+	EXPECT_EQ(vertexbuffer->store, nullptr);
+	EXPECT_TRUE(vertexbuffer->flags & RENDERBUFFER_DISCARDED);
+	EXPECT_NE(vertexbuffer->backing->spill, nullptr);
+	EXPECT_LT(vertexbuffer->backing->spill_size, sizeof(vertexdata));
+
+	// Incompressible data without source keeps its store
+	EXPECT_NE(randombuffer->store, nullptr);
+	EXPECT_FALSE(randombuffer->flags & RENDERBUFFER_DISCARDED);
+	EXPECT_FALSE(randombuffer->flags & RENDERBUFFER_DISCARD);
+
+	render_vertexbuffer_lock(vertexbuffer, RENDERBUFFER_LOCK_READ);
+	EXPECT_NE(vertexbuffer->access, nullptr);
+	EXPECT_FALSE(vertexbuffer->flags & RENDERBUFFER_DISCARDED);
+	EXPECT_EQ(memcmp(vertexbuffer->access, vertexdata, sizeof(vertexdata)), 0);
+	render_vertexbuffer_unlock(vertexbuffer);
+
+	// Read lock does not invalidate the spill cache, so the store is dropped again
+	EXPECT_EQ(vertexbuffer->store, nullptr);
+	render_vertexbuffer_lock(vertexbuffer, RENDERBUFFER_LOCK_READ);
+	EXPECT_EQ(memcmp(vertexbuffer->access, vertexdata, sizeof(vertexdata)), 0);
+	render_vertexbuffer_unlock(vertexbuffer);
+
+	render_vertexbuffer_deallocate(randombuffer);
+	render_vertexbuffer_deallocate(vertexbuffer);
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+DECLARE_TEST(render, vertex_convert) {
+	// Half away from zero, w component of 0.5 rounds to 1 and -0.5 to -1 on every path
+	const float32_t packed_source[8] = {1.0f, -1.0f, 0.0f, 0.5f, 2.0f, -2.0f, 0.0f, -0.5f};
+	uint32_t packed[2];
+	EXPECT_TRUE(render_vertex_convert(VERTEXFORMAT_INT1010102_SNORM, packed, sizeof(uint32_t),
+	                                  packed_source, sizeof(float32_t) * 4, 4, 2));
+	EXPECT_EQ(packed[0], 0x1FFU | (0x201U << 10) | (1U << 30));
+	EXPECT_EQ(packed[1], 0x1FFU | (0x201U << 10) | (3U << 30));
+
+	const float32_t normal_source[6] = {1.0f, -1.0f, 2.0f, 0.0f, 0.5f, -2.0f};
+	int16_t snorm[6];
+	EXPECT_TRUE(render_vertex_convert(VERTEXFORMAT_SHORT2_SNORM, snorm, sizeof(int16_t) * 2,
+	                                  normal_source, sizeof(float32_t) * 2, 2, 3));
+	EXPECT_EQ(snorm[0], 32767);
+	EXPECT_EQ(snorm[1], -32767);
+	EXPECT_EQ(snorm[2], 32767);
+	EXPECT_EQ(snorm[3], 0);
+	EXPECT_EQ(snorm[4], 16384);
+	EXPECT_EQ(snorm[5], -32767);
+
+	uint16_t unorm[6];
+	EXPECT_TRUE(render_vertex_convert(VERTEXFORMAT_USHORT2_UNORM, unorm, sizeof(uint16_t) * 2,
+	                                  normal_source, sizeof(float32_t) * 2, 2, 3));
+	EXPECT_EQ(unorm[0], 65535);
+	EXPECT_EQ(unorm[1], 0);
+	EXPECT_EQ(unorm[2], 65535);
+	EXPECT_EQ(unorm[3], 0);
+	EXPECT_EQ(unorm[4], 32768);
+	EXPECT_EQ(unorm[5], 0);
+
+	uint16_t half[6];
+	EXPECT_TRUE(render_vertex_convert(VERTEXFORMAT_HALF2, half, sizeof(uint16_t) * 2,
+	                                  normal_source, sizeof(float32_t) * 2, 2, 3));
+	EXPECT_EQ(half[0], 0x3C00);
+	EXPECT_EQ(half[1], 0xBC00);
+	EXPECT_EQ(half[2], 0x4000);
+	EXPECT_EQ(half[3], 0x0000);
+	EXPECT_EQ(half[4], 0x3800);
+	EXPECT_EQ(half[5], 0xC000);
+
+	// Missing source components convert to zero
+	const float32_t color_source[3] = {1.0f, 0.5f, 0.0f};
+	uint8_t color[4];
+	EXPECT_TRUE(render_vertex_convert(VERTEXFORMAT_UBYTE4_UNORM, color, sizeof(color),
+	                                  color_source, sizeof(color_source), 3, 1));
+	EXPECT_EQ(color[0], 255);
+	EXPECT_EQ(color[1], 128);
+	EXPECT_EQ(color[2], 0);
+	EXPECT_EQ(color[3], 0);
+
+	EXPECT_FALSE(render_vertex_convert(VERTEXFORMAT_UNUSED, color, sizeof(color), color_source,
+	                                   sizeof(color_source), 3, 1));
+
+	// Quantized declaration and conversion of interleaved vertex data
+	render_vertex_decl_t decl;
+	render_vertex_decl_t quantized_decl;
+	render_vertex_decl_t requantized_decl;
+	render_vertex_decl_initialize_varg(&decl, VERTEXFORMAT_FLOAT3, VERTEXATTRIBUTE_POSITION,
+	                                   VERTEXFORMAT_FLOAT3, VERTEXATTRIBUTE_NORMAL,
+	                                   VERTEXFORMAT_FLOAT2, VERTEXATTRIBUTE_TEXCOORD0,
+	                                   VERTEXFORMAT_UNKNOWN);
+	EXPECT_TRUE(render_vertex_decl_quantize(&quantized_decl, &decl));
+	EXPECT_EQ(quantized_decl.attribute[VERTEXATTRIBUTE_POSITION].format, VERTEXFORMAT_FLOAT3);
+	EXPECT_EQ(quantized_decl.attribute[VERTEXATTRIBUTE_NORMAL].format,
+	          VERTEXFORMAT_INT1010102_SNORM);
+	EXPECT_EQ(quantized_decl.attribute[VERTEXATTRIBUTE_TEXCOORD0].format, VERTEXFORMAT_HALF2);
+	EXPECT_EQ(render_vertex_decl_binding_stride(&quantized_decl, 0), 12 + 4 + 4);
+	EXPECT_FALSE(render_vertex_decl_quantize(&requantized_decl, &quantized_decl));
+
+	const float32_t vertex[8] = {1.0f, 2.0f, 3.0f, 0.0f, 1.0f, 0.0f, 0.5f, 1.0f};
+	uint8_t quantized[20];
+	EXPECT_TRUE(render_vertex_decl_convert(&quantized_decl, quantized, &decl, vertex, 1));
+	EXPECT_EQ(memcmp(quantized, vertex, sizeof(float32_t) * 3), 0);
+	uint32_t normal;
+	memcpy(&normal, quantized + 12, sizeof(normal));
+	EXPECT_EQ(normal, 0x1FFU << 10);
+	uint16_t texcoord[2];
+	memcpy(texcoord, quantized + 16, sizeof(texcoord));
+	EXPECT_EQ(texcoord[0], 0x3800);
+	EXPECT_EQ(texcoord[1], 0x3C00);
+
+	return 0;
+}
+
+DECLARE_TEST(render, transform_store) {
+	float32_t values[16];
+	float32_t viewproj_values[16];
+	for (unsigned int ival = 0; ival < 16; ++ival) {
+		values[ival] = (float32_t)(ival + 1);
+		viewproj_values[ival] = (float32_t)(ival % 5) - 1.0f;
+	}
+	matrix_t model[2];
+	matrix_t viewproj;
+	memcpy(&model[0], values, sizeof(matrix_t));
+	model[1] = matrix_identity();
+	memcpy(&viewproj, viewproj_values, sizeof(matrix_t));
+
+	// Palette layout is column major
+	float32_t column_major[16];
+	render_transform_store(column_major, &model[0]);
+	for (unsigned int row = 0; row < 4; ++row) {
+		for (unsigned int col = 0; col < 4; ++col)
+			EXPECT_REALEQ(column_major[(col * 4) + row], values[(row * 4) + col]);
+	}
+
+	// Matrix parameters are row major, stored at the parameter offset
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_parameter_t parameter;
+	memset(&parameter, 0, sizeof(parameter));
+	parameter.name = hash(STRING_CONST("mvp"));
+	parameter.type = RENDERPARAMETER_MATRIX;
+	parameter.dim = 1;
+	parameter.offset = sizeof(matrix_t);
+
+	render_parameterbuffer_t* buffers[2];
+	uint32_t generation[2];
+	for (unsigned int ibuf = 0; ibuf < 2; ++ibuf) {
+		buffers[ibuf] = render_parameterbuffer_allocate(backend, RENDERUSAGE_DYNAMIC, &parameter, 1,
+		                                                nullptr, sizeof(matrix_t) * 2);
+		memset(buffers[ibuf]->store, 0, sizeof(matrix_t) * 2);
+		generation[ibuf] = buffers[ibuf]->generation;
+	}
+
+	render_transform_store_batch(&viewproj, model, 2, buffers, &parameter);
+
+	for (unsigned int ibuf = 0; ibuf < 2; ++ibuf) {
+		const float32_t* source = (const float32_t*)(model + ibuf);
+		const float32_t* stored = pointer_offset(buffers[ibuf]->store, parameter.offset);
+		EXPECT_NE(buffers[ibuf]->generation, generation[ibuf]);
+		EXPECT_REALEQ(*(const float32_t*)buffers[ibuf]->store, 0);
+		for (unsigned int row = 0; row < 4; ++row) {
+			for (unsigned int col = 0; col < 4; ++col) {
+				float32_t expect = 0;
+				for (unsigned int ik = 0; ik < 4; ++ik)
+					expect += source[(row * 4) + ik] * viewproj_values[(ik * 4) + col];
+				EXPECT_REALEQ(stored[(row * 4) + col], expect);
+			}
+		}
+	}
+
+	// Column major matrix parameters store the transposed product, uploaded as is
+	parameter.type = RENDERPARAMETER_MATRIX_COLUMN;
+	render_transform_store_batch(&viewproj, model, 2, buffers, &parameter);
+	for (unsigned int ibuf = 0; ibuf < 2; ++ibuf) {
+		const float32_t* source = (const float32_t*)(model + ibuf);
+		const float32_t* stored = pointer_offset(buffers[ibuf]->store, parameter.offset);
+		for (unsigned int row = 0; row < 4; ++row) {
+			for (unsigned int col = 0; col < 4; ++col) {
+				float32_t expect = 0;
+				for (unsigned int ik = 0; ik < 4; ++ik)
+					expect += source[(row * 4) + ik] * viewproj_values[(ik * 4) + col];
+				EXPECT_REALEQ(stored[(col * 4) + row], expect);
+			}
+		}
+	}
+
+	render_parameterbuffer_deallocate(buffers[1]);
+	render_parameterbuffer_deallocate(buffers[0]);
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+DECLARE_TEST(render, sort_key) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_vertex_decl_t decl[2];
+	render_vertex_decl_initialize_varg(&decl[0], VERTEXFORMAT_FLOAT3, VERTEXATTRIBUTE_POSITION,
+	                                   VERTEXFORMAT_UNKNOWN);
+	render_vertex_decl_initialize_varg(&decl[1], VERTEXFORMAT_FLOAT4, VERTEXATTRIBUTE_POSITION,
+	                                   VERTEXFORMAT_UNKNOWN);
+	render_vertexbuffer_t* vertexbuffer[2];
+	for (unsigned int ibuf = 0; ibuf < 2; ++ibuf)
+		vertexbuffer[ibuf] = render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0,
+		                                                  &decl[ibuf], nullptr, 0);
+	EXPECT_NE(vertexbuffer[0]->decl_id, vertexbuffer[1]->decl_id);
+	unsigned int ilater = (vertexbuffer[0]->decl_id > vertexbuffer[1]->decl_id) ? 0 : 1;
+	render_buffer_t* later = (render_buffer_t*)vertexbuffer[ilater];
+	render_buffer_t* earlier = (render_buffer_t*)vertexbuffer[1 - ilater];
+
+	render_context_t* context = render_context_allocate(32);
+	render_sort_reset(context);
+
+	// Draws are grouped by layout only between viewport and clear commands
+	uint64_t viewport = render_sort_sequential_key(context);
+	uint64_t draw_later = render_sort_render_key(context, later, nullptr, nullptr);
+	uint64_t draw_earlier = render_sort_render_key(context, earlier, nullptr, nullptr);
+	uint64_t draw_earlier_next = render_sort_render_key(context, earlier, nullptr, nullptr);
+	uint64_t clear = render_sort_sequential_key(context);
+	uint64_t draw_after_clear = render_sort_render_key(context, later, nullptr, nullptr);
+	uint64_t viewport_next = render_sort_sequential_key(context);
+
+	EXPECT_LT(viewport, draw_earlier);
+	EXPECT_LT(draw_earlier, draw_earlier_next);
+	EXPECT_LT(draw_earlier_next, draw_later);
+	EXPECT_LT(draw_later, clear);
+	EXPECT_LT(clear, draw_after_clear);
+	EXPECT_LT(draw_after_clear, viewport_next);
+
+	render_context_deallocate(context);
+	render_vertexbuffer_deallocate(vertexbuffer[1]);
+	render_vertexbuffer_deallocate(vertexbuffer[0]);
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+DECLARE_TEST(render, pool_handle) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_vertex_decl_t decl;
+	render_vertex_decl_initialize_varg(&decl, VERTEXFORMAT_FLOAT3, VERTEXATTRIBUTE_POSITION,
+	                                   VERTEXFORMAT_UNKNOWN);
+
+	render_vertexbuffer_t* vertexbuffer =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0, &decl, nullptr, 0);
+	render_handle_t handle = render_buffer_handle(vertexbuffer);
+	EXPECT_NE(handle, RENDER_HANDLE_INVALID);
+	EXPECT_EQ((void*)render_buffer_resolve(handle), (void*)vertexbuffer);
+	EXPECT_EQ(render_buffer_resolve(RENDER_HANDLE_INVALID), nullptr);
+
+	render_vertexbuffer_t* base =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0, &decl, nullptr, 0);
+	render_vertexbuffer_t* streams[2] = {base, vertexbuffer};
+	render_command_t command;
+	render_command_render_streams(&command, RENDERPRIMITIVE_TRIANGLELIST, 0, nullptr, streams, 2,
+	                              nullptr, nullptr, nullptr);
+
+	// Handle stays valid until the queued destruction executes at flip
+	render_vertexbuffer_deallocate(vertexbuffer);
+	EXPECT_EQ((void*)render_buffer_resolve(handle), (void*)vertexbuffer);
+	for (unsigned int iframe = 0; iframe <= RENDER_FRAMES_IN_FLIGHT_MAX; ++iframe)
+		render_backend_flip(backend);
+	EXPECT_EQ(render_buffer_resolve(handle), nullptr);
+
+	// Reused slot gets a new generation, the stale handle does not resolve to the new buffer
+	render_vertexbuffer_t* reused =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0, &decl, nullptr, 0);
+	render_handle_t reused_handle = render_buffer_handle(reused);
+	EXPECT_EQ((void*)reused, (void*)vertexbuffer);
+	EXPECT_NE(reused_handle, handle);
+	EXPECT_EQ((void*)render_buffer_resolve(reused_handle), (void*)reused);
+	EXPECT_EQ(render_buffer_resolve(handle), nullptr);
+
+	// Vertex stream handles are resolved at dispatch as well, a command recorded before the
+	// stream was destroyed is skipped even though the slot now holds another buffer
+	render_context_t* context = render_context_allocate(1);
+	memcpy(render_context_reserve(context, 0), &command, sizeof(command));
+	render_sort_merge(&context, 1);
+	render_backend_dispatch(backend, render_backend_target_framebuffer(backend), &context, 1);
+	EXPECT_EQ(context->commands[0].type, RENDERCOMMAND_INVALID);
+	render_context_deallocate(context);
+
+	// Buffers outside the pool have no handle
+	uint8_t unpooled[sizeof(render_vertexbuffer_t)];
+	EXPECT_EQ(render_buffer_handle(unpooled), RENDER_HANDLE_INVALID);
+
+	render_vertexbuffer_deallocate(reused);
+	render_vertexbuffer_deallocate(base);
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+DECLARE_TEST(render, destroy_latency) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_vertex_decl_t decl;
+	render_vertex_decl_initialize_varg(&decl, VERTEXFORMAT_FLOAT3, VERTEXATTRIBUTE_POSITION,
+	                                   VERTEXFORMAT_UNKNOWN);
+
+	render_vertexbuffer_t* first =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0, &decl, nullptr, 0);
+	render_vertexbuffer_t* second =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0, &decl, nullptr, 0);
+	render_handle_t first_handle = render_buffer_handle(first);
+	render_handle_t second_handle = render_buffer_handle(second);
+
+	// Default configuration keeps two frames in flight, so a resource released during
+	// a frame is destroyed at the third flip after the release
+	render_vertexbuffer_deallocate(first);
+	render_backend_flip(backend);
+	render_backend_flip(backend);
+	EXPECT_EQ((void*)render_buffer_resolve(first_handle), (void*)first);
+
+	render_vertexbuffer_deallocate(second);
+	render_backend_flip(backend);
+	EXPECT_EQ(render_buffer_resolve(first_handle), nullptr);
+	EXPECT_EQ((void*)render_buffer_resolve(second_handle), (void*)second);
+
+	render_backend_flip(backend);
+	EXPECT_EQ((void*)render_buffer_resolve(second_handle), (void*)second);
+	render_backend_flip(backend);
+	EXPECT_EQ(render_buffer_resolve(second_handle), nullptr);
+
+	// Pending releases are destroyed immediately when the backend is deallocated
+	render_vertexbuffer_t* pending =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0, &decl, nullptr, 0);
+	render_handle_t pending_handle = render_buffer_handle(pending);
+	render_vertexbuffer_deallocate(pending);
+	render_backend_deallocate(backend);
+	EXPECT_EQ(render_buffer_resolve(pending_handle), nullptr);
+
+	return 0;
+}
+
+static bool
+_test_render_dispatch_clear(render_backend_t* backend, render_target_t* target,
+                            render_context_t* context, uint32_t color) {
+	render_sort_reset(context);
+	render_command_clear(render_context_reserve(context, render_sort_sequential_key(context)),
+	                     RENDERBUFFER_COLOR, color, 0xF, 1, 0);
+	render_sort_merge(&context, 1);
+	return render_backend_dispatch(backend, target, &context, 1);
+}
+
+static uint32_t _test_pipeline_clear_color[2];
+static unsigned int _test_pipeline_clear_count;
+
+static void
+_test_render_pipeline_clear(render_backend_t* backend, render_target_t* target,
+                            render_context_t** contexts, size_t num_contexts) {
+	FOUNDATION_UNUSED(backend);
+	FOUNDATION_UNUSED(target);
+	FOUNDATION_UNUSED(num_contexts);
+	uint32_t color = _test_pipeline_clear_color[_test_pipeline_clear_count++ % 2];
+	render_command_clear(render_context_reserve(contexts[0], 0), RENDERBUFFER_COLOR, color, 0xF,
+	                     1, 0);
+}
+
+DECLARE_TEST(render, idle_hash) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_backend_set_skip_idle(backend, true);
+	render_target_t* framebuffer = render_backend_target_framebuffer(backend);
+	render_target_t scene;
+	memset(&scene, 0, sizeof(scene));
+	render_context_t* context = render_context_allocate(32);
+
+	// The back buffer is undefined after a swap, a frame buffer dispatch followed by another
+	// dispatch is not known to be idle and is dispatched even if unchanged
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFF0000FF));
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFF00FF00));
+	EXPECT_TRUE(render_backend_flip(backend));
+
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFF0000FF));
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFFFF0000));
+	EXPECT_TRUE(render_backend_flip(backend));
+
+	// Dispatches are each matched to their own previous hash, the frame buffer dispatch
+	// ending the frame is skipped with the rest of an idle frame
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, &scene, context, 0xFF0000FF));
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFF00FF00));
+	EXPECT_TRUE(render_backend_flip(backend));
+
+	uint64_t framecount = render_backend_frame_count(backend);
+	EXPECT_FALSE(_test_render_dispatch_clear(backend, &scene, context, 0xFF0000FF));
+	EXPECT_FALSE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFF00FF00));
+	EXPECT_FALSE(render_backend_flip(backend));
+	EXPECT_EQ(render_backend_frame_count(backend), framecount + 1);
+
+	// Offscreen content persists across flips, a changed dispatch is not skipped even if
+	// earlier dispatches to other targets in the frame were
+	EXPECT_FALSE(_test_render_dispatch_clear(backend, &scene, context, 0xFF0000FF));
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFFFF0000));
+	EXPECT_TRUE(render_backend_flip(backend));
+
+	// Idle flips still drain the destroy queue
+	render_vertex_decl_t decl;
+	render_vertex_decl_initialize_varg(&decl, VERTEXFORMAT_FLOAT3, VERTEXATTRIBUTE_POSITION,
+	                                   VERTEXFORMAT_UNKNOWN);
+	render_vertexbuffer_t* vertexbuffer =
+	    render_vertexbuffer_allocate(backend, RENDERUSAGE_STATIC, 0, 0, &decl, nullptr, 0);
+	render_handle_t handle = render_buffer_handle(vertexbuffer);
+	render_vertexbuffer_deallocate(vertexbuffer);
+	for (unsigned int iframe = 0; iframe <= RENDER_FRAMES_IN_FLIGHT_MAX; ++iframe) {
+		EXPECT_FALSE(_test_render_dispatch_clear(backend, &scene, context, 0xFF0000FF));
+		EXPECT_FALSE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFFFF0000));
+		EXPECT_FALSE(render_backend_flip(backend));
+	}
+	EXPECT_EQ(render_buffer_resolve(handle), nullptr);
+
+	// A dispatch following a skipped frame buffer dispatch leaves the frame incomplete, the
+	// previous frame stays presented and the next frame is dispatched in full
+	EXPECT_FALSE(_test_render_dispatch_clear(backend, &scene, context, 0xFF0000FF));
+	EXPECT_FALSE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFFFF0000));
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, &scene, context, 0xFF00FF00));
+	EXPECT_FALSE(render_backend_flip(backend));
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, &scene, context, 0xFF0000FF));
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFFFF0000));
+	EXPECT_TRUE(render_backend_flip(backend));
+
+	// Pipeline steps are all hashed before dispatch, frames with several frame buffer
+	// dispatches are skipped as a whole or dispatched in full
+	render_pipeline_t* pipeline = render_pipeline_allocate(backend);
+	render_pipeline_step_t step;
+	for (unsigned int istep = 0; istep < 2; ++istep) {
+		render_pipeline_step_initialize(&step, framebuffer, _test_render_pipeline_clear);
+		array_push(step.contexts, render_context_allocate(4));
+		array_push(pipeline->steps, step);
+	}
+	_test_pipeline_clear_color[0] = 0xFF0000FF;
+	_test_pipeline_clear_color[1] = 0xFF00FF00;
+	render_pipeline_execute(pipeline);
+	EXPECT_TRUE(render_pipeline_dispatch(pipeline));
+	EXPECT_TRUE(render_backend_flip(backend));
+
+	render_pipeline_execute(pipeline);
+	EXPECT_FALSE(render_pipeline_dispatch(pipeline));
+	EXPECT_EQ(render_pipeline_statistics(pipeline, 0)->skipped, 2);
+	EXPECT_FALSE(render_backend_flip(backend));
+
+	_test_pipeline_clear_color[1] = 0xFFFF0000;
+	render_pipeline_execute(pipeline);
+	EXPECT_TRUE(render_pipeline_dispatch(pipeline));
+	EXPECT_EQ(render_pipeline_statistics(pipeline, 0)->dispatched, 2);
+	EXPECT_FALSE(render_pipeline_step_statistics(pipeline, 0, 0)->skipped);
+	EXPECT_TRUE(render_backend_flip(backend));
+	render_pipeline_deallocate(pipeline);
+
+	// Disabling skips clears the previous hashes
+	render_backend_set_skip_idle(backend, false);
+	EXPECT_TRUE(_test_render_dispatch_clear(backend, framebuffer, context, 0xFF0000FF));
+	EXPECT_TRUE(render_backend_flip(backend));
+
+	render_context_deallocate(context);
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+static render_target_t* _test_pipeline_recorded[8];
+static size_t _test_pipeline_recorded_count;
+
+static void
+_test_render_pipeline_record(render_backend_t* backend, render_target_t* target,
+                             render_context_t** contexts, size_t num_contexts) {
+	FOUNDATION_UNUSED(backend);
+	FOUNDATION_UNUSED(contexts);
+	FOUNDATION_UNUSED(num_contexts);
+	if (_test_pipeline_recorded_count < sizeof(_test_pipeline_recorded) / sizeof(render_target_t*))
+		_test_pipeline_recorded[_test_pipeline_recorded_count++] = target;
+}
+
+DECLARE_TEST(render, pipeline_graph) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_target_t* framebuffer = render_backend_target_framebuffer(backend);
+	render_target_t scene, unused, output;
+	memset(&scene, 0, sizeof(scene));
+	memset(&unused, 0, sizeof(unused));
+	memset(&output, 0, sizeof(output));
+
+	// Composite step is added first but reads the scene rendered by the second step
+	render_pipeline_t* pipeline = render_pipeline_allocate(backend);
+	render_pipeline_step_t step;
+	render_pipeline_step_initialize(&step, framebuffer, _test_render_pipeline_record);
+	render_pipeline_step_read(&step, &scene);
+	array_push(pipeline->steps, step);
+	render_pipeline_step_initialize(&step, &scene, _test_render_pipeline_record);
+	array_push(pipeline->steps, step);
+	render_pipeline_step_initialize(&step, &unused, _test_render_pipeline_record);
+	array_push(pipeline->steps, step);
+	render_pipeline_step_initialize(&step, &output, _test_render_pipeline_record);
+	array_push(pipeline->steps, step);
+
+	// Without outputs every step is kept, independent steps keep the order they were added in
+	_test_pipeline_recorded_count = 0;
+	render_pipeline_execute(pipeline);
+	render_pipeline_dispatch(pipeline);
+	EXPECT_EQ(array_size(pipeline->order), 4);
+	EXPECT_EQ(pipeline->order[0], 1);
+	EXPECT_EQ(pipeline->order[1], 0);
+	EXPECT_EQ(pipeline->order[2], 2);
+	EXPECT_EQ(pipeline->order[3], 3);
+	EXPECT_EQ(_test_pipeline_recorded_count, 4);
+	EXPECT_EQ((void*)_test_pipeline_recorded[0], (void*)&scene);
+	EXPECT_EQ((void*)_test_pipeline_recorded[1], (void*)framebuffer);
+
+	// Declaring an output culls the step contributing to neither an output nor the frame buffer
+	render_pipeline_add_output(pipeline, &output);
+	_test_pipeline_recorded_count = 0;
+	render_pipeline_execute(pipeline);
+	render_pipeline_dispatch(pipeline);
+	EXPECT_EQ(array_size(pipeline->order), 3);
+	EXPECT_EQ(pipeline->order[0], 1);
+	EXPECT_EQ(pipeline->order[1], 0);
+	EXPECT_EQ(pipeline->order[2], 3);
+	EXPECT_EQ(_test_pipeline_recorded_count, 3);
+	EXPECT_EQ((void*)_test_pipeline_recorded[2], (void*)&output);
+
+	const render_pipeline_statistics_t* statistics = render_pipeline_statistics(pipeline, 0);
+	EXPECT_NE(statistics, nullptr);
+	EXPECT_EQ(statistics->culled, 1);
+	EXPECT_TRUE(render_pipeline_step_statistics(pipeline, 2, 0)->culled);
+	EXPECT_FALSE(render_pipeline_step_statistics(pipeline, 0, 0)->culled);
+
+	render_pipeline_deallocate(pipeline);
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+DECLARE_TEST(render, pipeline_transient) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_target_t* framebuffer = render_backend_target_framebuffer(backend);
+	render_pipeline_t* pipeline = render_pipeline_allocate(backend);
+	render_target_t* first =
+	    render_pipeline_transient_target(pipeline, 64, 64, PIXELFORMAT_R8G8B8A8, COLORSPACE_LINEAR);
+	render_target_t* second =
+	    render_pipeline_transient_target(pipeline, 64, 64, PIXELFORMAT_R8G8B8A8, COLORSPACE_LINEAR);
+	render_target_t* overlapping =
+	    render_pipeline_transient_target(pipeline, 64, 64, PIXELFORMAT_R8G8B8A8, COLORSPACE_LINEAR);
+
+	// Two passes each rendering a transient target and composing it to the frame buffer
+	render_pipeline_step_t step;
+	render_pipeline_step_initialize(&step, first, nullptr);
+	array_push(pipeline->steps, step);
+	render_pipeline_step_initialize(&step, framebuffer, nullptr);
+	render_pipeline_step_read(&step, first);
+	array_push(pipeline->steps, step);
+	render_pipeline_step_initialize(&step, second, nullptr);
+	array_push(pipeline->steps, step);
+	render_pipeline_step_initialize(&step, framebuffer, nullptr);
+	render_pipeline_step_read(&step, second);
+	array_push(pipeline->steps, step);
+
+	// Targets whose steps do not overlap in dispatch order share storage
+	render_pipeline_execute(pipeline);
+	render_pipeline_dispatch(pipeline);
+	EXPECT_EQ(array_size(pipeline->storage), 1);
+	EXPECT_EQ(pipeline->transients[0]->storage, 1);
+	EXPECT_EQ(pipeline->transients[1]->storage, 1);
+	EXPECT_EQ(pipeline->transients[2]->storage, 0);
+	EXPECT_EQ(overlapping->backend, nullptr);
+	render_backend_flip(backend);
+
+	// Target used from the first to the last step overlaps both and gets its own storage
+	render_pipeline_step_write(pipeline->steps + 0, overlapping);
+	render_pipeline_step_read(pipeline->steps + 3, overlapping);
+	render_pipeline_execute(pipeline);
+	render_pipeline_dispatch(pipeline);
+	EXPECT_EQ(array_size(pipeline->storage), 2);
+	EXPECT_EQ(pipeline->transients[0]->storage, pipeline->transients[1]->storage);
+	EXPECT_NE(pipeline->transients[2]->storage, pipeline->transients[0]->storage);
+	EXPECT_NE(pipeline->transients[2]->storage, 0);
+	render_backend_flip(backend);
+
+	// Storage is released through deferred destruction and outlives the pipeline until flipped
+	render_handle_t storage_handle = render_target_handle(pipeline->storage[0].target);
+	EXPECT_NE(storage_handle, RENDER_HANDLE_INVALID);
+	render_pipeline_deallocate(pipeline);
+	EXPECT_NE(render_target_resolve(storage_handle), nullptr);
+	for (unsigned int iframe = 0; iframe <= RENDER_FRAMES_IN_FLIGHT_MAX; ++iframe)
+		render_backend_flip(backend);
+	EXPECT_EQ(render_target_resolve(storage_handle), nullptr);
+
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+static render_program_t _test_prepass_program[3];
+static render_statebuffer_t* _test_prepass_blended;
+static render_statebuffer_t* _test_prepass_opaque;
+
+static render_program_t*
+_test_render_depth_program(render_program_t* program) {
+	// Second program has no position only variant and is left out of the pre-pass
+	return (program == _test_prepass_program) ? _test_prepass_program + 2 : nullptr;
+}
+
+static void
+_test_render_prepass_draw(render_context_t* context, render_program_t* program,
+                          render_statebuffer_t* statebuffer, float32_t depth) {
+	render_command_t* command =
+	    render_context_reserve(context, render_sort_sequential_key(context));
+	render_command_render(command, RENDERPRIMITIVE_TRIANGLELIST, 3, program, nullptr, nullptr,
+	                      nullptr, statebuffer);
+	render_command_set_depth(command, depth);
+}
+
+static void
+_test_render_prepass_record(render_backend_t* backend, render_target_t* target,
+                            render_context_t** contexts, size_t num_contexts) {
+	FOUNDATION_UNUSED(backend);
+	FOUNDATION_UNUSED(target);
+	FOUNDATION_UNUSED(num_contexts);
+	render_context_t* context = contexts[0];
+	render_command_clear(render_context_reserve(context, render_sort_sequential_key(context)),
+	                     RENDERBUFFER_COLOR | RENDERBUFFER_DEPTH | RENDERBUFFER_STENCIL, 0, 0xF, 1,
+	                     0);
+	_test_render_prepass_draw(context, _test_prepass_program, nullptr, 5);
+	_test_render_prepass_draw(context, _test_prepass_program, nullptr, 1);
+	_test_render_prepass_draw(context, _test_prepass_program, _test_prepass_blended, 0.5f);
+	_test_render_prepass_draw(context, _test_prepass_program + 1, nullptr, 0.25f);
+	render_command_viewport(render_context_reserve(context, render_sort_sequential_key(context)),
+	                        0, 0, 32, 32, 0, 1);
+	_test_render_prepass_draw(context, _test_prepass_program, _test_prepass_opaque, 3);
+	render_command_clear(render_context_reserve(context, render_sort_sequential_key(context)),
+	                     RENDERBUFFER_DEPTH, 0, 0, 1, 0);
+	_test_render_prepass_draw(context, _test_prepass_program, nullptr, 2);
+}
+
+static const render_command_t*
+_test_render_sorted_command(const render_context_t* context, size_t iorder) {
+	size_t index = (context->sort->indextype == RADIXSORT_INDEX16) ?
+	                   ((const uint16_t*)context->order)[iorder] :
+	                   ((const uint32_t*)context->order)[iorder];
+	return context->commands + index;
+}
+
+DECLARE_TEST(render, depth_prepass) {
+	render_backend_t* backend = render_backend_allocate(RENDERAPI_NULL, false);
+	EXPECT_NE(backend, nullptr);
+
+	render_state_t state = render_state_default();
+	state.blend_enable[0] = true;
+	_test_prepass_blended = render_statebuffer_allocate(backend, RENDERUSAGE_DYNAMIC, state);
+	_test_prepass_opaque =
+	    render_statebuffer_allocate(backend, RENDERUSAGE_DYNAMIC, render_state_default());
+
+	render_target_t* framebuffer = render_backend_target_framebuffer(backend);
+	render_pipeline_t* pipeline = render_pipeline_allocate(backend);
+	render_pipeline_step_t step;
+	render_pipeline_step_depth_prepass_initialize(&step, framebuffer, 1,
+	                                              _test_render_depth_program);
+	array_push(pipeline->steps, step);
+	render_pipeline_step_initialize(&step, framebuffer, _test_render_prepass_record);
+	array_push(step.contexts, render_context_allocate(16));
+	array_push(pipeline->steps, step);
+
+	render_pipeline_execute(pipeline);
+	EXPECT_TRUE(render_pipeline_dispatch(pipeline));
+	EXPECT_EQ(pipeline->order[0], 0);
+	EXPECT_EQ(pipeline->order[1], 1);
+
+	// Depth clears and opaque draws with a depth program variant are derived, blended draws
+	// and draws without a variant are left out
+	const render_pipeline_step_statistics_t* statistics =
+	    render_pipeline_step_statistics(pipeline, 0, 0);
+	EXPECT_EQ(statistics->commands[RENDERCOMMAND_CLEAR], 2);
+	EXPECT_EQ(statistics->commands[RENDERCOMMAND_VIEWPORT], 1);
+	EXPECT_EQ(statistics->commands[RENDERCOMMAND_RENDER_TRIANGLELIST], 4);
+
+	// Draws are ordered front to back within the segment between clears and viewports
+	const render_context_t* prepass = pipeline->steps[0].contexts[0];
+	const render_command_t* derived[7];
+	for (size_t iorder = 0; iorder < 7; ++iorder)
+		derived[iorder] = _test_render_sorted_command(prepass, iorder);
+	EXPECT_EQ(derived[0]->type, RENDERCOMMAND_CLEAR);
+	EXPECT_EQ(derived[0]->data.clear.buffer_mask, RENDERBUFFER_DEPTH | RENDERBUFFER_STENCIL);
+	EXPECT_REALEQ(derived[1]->data.render.depth, 1);
+	EXPECT_REALEQ(derived[2]->data.render.depth, 5);
+	EXPECT_EQ(derived[3]->type, RENDERCOMMAND_VIEWPORT);
+	EXPECT_REALEQ(derived[4]->data.render.depth, 3);
+	EXPECT_EQ(derived[5]->type, RENDERCOMMAND_CLEAR);
+	EXPECT_EQ(derived[5]->data.clear.buffer_mask, RENDERBUFFER_DEPTH);
+	EXPECT_REALEQ(derived[6]->data.render.depth, 2);
+
+	// Derived draws use the depth program variant and a depth only state
+	const render_statebuffer_t* depth = derived[1]->data.render.statebuffer;
+	EXPECT_EQ((void*)derived[1]->data.render.program, (void*)(_test_prepass_program + 2));
+	EXPECT_NE(depth, nullptr);
+	EXPECT_FALSE(depth->state.blend_enable[0]);
+	EXPECT_FALSE(depth->state.target_write[0]);
+	EXPECT_TRUE(depth->state.depth_write);
+	EXPECT_EQ((void*)derived[2]->data.render.statebuffer, (void*)depth);
+	EXPECT_NE((void*)derived[4]->data.render.statebuffer, (void*)depth);
+	EXPECT_FALSE(derived[4]->data.render.statebuffer->state.target_write[0]);
+
+	// Source draws test depth for equality without writing it, source clears keep the
+	// remaining buffers or are dropped if only depth was cleared
+	const render_command_t* source = pipeline->steps[1].contexts[0]->commands;
+	EXPECT_EQ(source[0].data.clear.buffer_mask, RENDERBUFFER_COLOR);
+	const render_statebuffer_t* equal = source[1].data.render.statebuffer;
+	EXPECT_NE(equal, nullptr);
+	EXPECT_EQ(equal->state.depth_func, RENDER_CMP_EQUAL);
+	EXPECT_FALSE(equal->state.depth_write);
+	EXPECT_EQ((void*)source[2].data.render.statebuffer, (void*)equal);
+	EXPECT_EQ((void*)source[3].data.render.statebuffer, (void*)_test_prepass_blended);
+	EXPECT_EQ(source[4].data.render.statebuffer, nullptr);
+	EXPECT_EQ(source[6].data.render.statebuffer->state.depth_func, RENDER_CMP_EQUAL);
+	EXPECT_TRUE(source[6].data.render.statebuffer->state.target_write[0]);
+	EXPECT_EQ(source[7].type, RENDERCOMMAND_INVALID);
+
+	render_pipeline_deallocate(pipeline);
+	render_statebuffer_deallocate(_test_prepass_opaque);
+	render_statebuffer_deallocate(_test_prepass_blended);
+	render_backend_deallocate(backend);
+
+	return 0;
+}
+
+DECLARE_TEST(render, scaling) {
+	render_scaling_t scaling;
+	real target_time = REAL_C(1.0) / REAL_C(60.0);
+	render_scaling_initialize(&scaling, 1000, 500, REAL_C(0.5), REAL_C(1.0), target_time);
+	render_scaling_set_hysteresis(&scaling, REAL_C(0.1), 4, REAL_C(0.1));
+	EXPECT_EQ(scaling.width, 1000);
+	EXPECT_EQ(scaling.height, 500);
+
+	// Scale only changes after a run of frames outside the tolerance
+	for (unsigned int iframe = 0; iframe < 3; ++iframe)
+		EXPECT_FALSE(render_scaling_update(&scaling, target_time * REAL_C(2.0)));
+	EXPECT_FALSE(render_scaling_update(&scaling, target_time));
+	for (unsigned int iframe = 0; iframe < 3; ++iframe)
+		EXPECT_FALSE(render_scaling_update(&scaling, target_time * REAL_C(2.0)));
+	EXPECT_EQ(scaling.width, 1000);
+
+	// Slow frames lower the scale in proportion to the pixel cost
+	EXPECT_TRUE(render_scaling_update(&scaling, target_time * REAL_C(2.0)));
+	EXPECT_EQ(scaling.width, 707);
+	EXPECT_EQ(scaling.height, 354);
+
+	// Fast frames raise the scale by the step
+	for (unsigned int iframe = 0; iframe < 3; ++iframe)
+		EXPECT_FALSE(render_scaling_update(&scaling, target_time * REAL_C(0.5)));
+	EXPECT_TRUE(render_scaling_update(&scaling, target_time * REAL_C(0.5)));
+	EXPECT_EQ(scaling.width, 807);
+
+	// Scale is clamped to the bounds
+	for (unsigned int iframe = 0; iframe < 8; ++iframe)
+		render_scaling_update(&scaling, target_time * REAL_C(10.0));
+	EXPECT_REALEQ(scaling.scale, REAL_C(0.5));
+	EXPECT_EQ(scaling.width, 500);
+	EXPECT_EQ(scaling.height, 250);
+	for (unsigned int iframe = 0; iframe < 32; ++iframe)
+		render_scaling_update(&scaling, target_time * REAL_C(0.5));
+	EXPECT_REALEQ(scaling.scale, REAL_C(1.0));
+	EXPECT_EQ(scaling.width, 1000);
+	for (unsigned int iframe = 0; iframe < 4; ++iframe)
+		EXPECT_FALSE(render_scaling_update(&scaling, target_time * REAL_C(0.5)));
+
+	render_command_t command;
+	render_scaling_viewport(&scaling, &command, 0, 1);
+	EXPECT_EQ(command.data.viewport.width, 1000);
+	EXPECT_EQ(command.data.viewport.height, 500);
+
+	// Native resolution change keeps the scale
+	EXPECT_TRUE(render_scaling_set_native(&scaling, 2000, 1000));
+	EXPECT_EQ(scaling.width, 2000);
+	EXPECT_EQ(scaling.height, 1000);
+
+	render_scaling_finalize(&scaling);
+
+	return 0;
+}
+
 static void
 test_render_declare(void) {
 	ADD_TEST(render, initialize);
 	ADD_TEST(render, null);
 	ADD_TEST(render, null_clear);
 	ADD_TEST(render, null_box);
+	ADD_TEST(render, buffer_spill);
+	ADD_TEST(render, vertex_convert);
+	ADD_TEST(render, transform_store);
+	ADD_TEST(render, sort_key);
+	ADD_TEST(render, pool_handle);
+	ADD_TEST(render, destroy_latency);
+	ADD_TEST(render, idle_hash);
+	ADD_TEST(render, pipeline_graph);
+	ADD_TEST(render, pipeline_transient);
+	ADD_TEST(render, depth_prepass);
+	ADD_TEST(render, scaling);
 #if FOUNDATION_PLATFORM_WINDOWS || FOUNDATION_PLATFORM_MACOS || FOUNDATION_PLATFORM_LINUX
 	ADD_TEST(render, gl4);
 	ADD_TEST(render, gl4_clear);